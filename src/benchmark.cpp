@@ -0,0 +1,274 @@
+//--------------------------------------------------
+// Boids Basic
+// benchmark.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "forceField.h"
+#include "heatMap.h"
+#include "profiler.h"
+#include "random.h"
+#include "sceneFile.h"
+#include "simulation.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+
+// Benchmarks of each phase of the boid step. Arguments are scaled to integers:
+//  - boids: number of boids
+//  - radius: view radius in tenths
+//  - density: boids per unit area (sets the arena size, which is twice as wide as it is high)
+//  - obstacles: number of random disks
+// Use --benchmark_out=<file.json> --benchmark_out_format=json (or the benchmark_json target) to save the results
+
+static std::unique_ptr<Simulation> createSimulation(uint32_t numBoids, float viewRadius, float density, uint32_t numObstacles,
+                                                    uint32_t numThreads = 1) {
+    float height = std::sqrt(numBoids / density / 2.0f);
+    Scene scene = generateScene(height * 2.0f, height, numObstacles, 42);
+    scene.settings.viewRadius = viewRadius;
+    scene.settings.numThreads = numThreads;
+
+    auto sim = std::make_unique<Simulation>();
+    sim->setSettings(scene.settings);
+    sim->setSeed(42);
+    sim->setForceFieldSources(scene.sources);
+    sim->initBoids(numBoids);
+
+    // Let the flock form a bit
+    for (int i = 0; i < 5; i++)
+        sim->step(0.01f);
+    return sim;
+}
+
+static void setCounters(benchmark::State& state, const Simulation& sim) {
+    state.SetItemsProcessed(state.iterations() * sim.getState().size());
+    state.counters["neighbors"] = benchmark::Counter(float(sim.getNeighbors().getTotal()) / std::max(sim.getState().size(), 1u));
+}
+
+//---------- Boid step phases ----------//
+static void boidArgs(benchmark::internal::Benchmark* b) {
+    b->ArgNames({"boids", "radius", "density"});
+    b->ArgsProduct({{100, 1000, 10000, 100000}, {5, 10, 20}, {1, 4}});
+    b->Unit(benchmark::kMicrosecond);
+}
+
+static void BM_Neighbors(benchmark::State& state) {
+    auto sim = createSimulation(state.range(0), state.range(1) / 10.0f, state.range(2), 3);
+    for (auto _ : state)
+        sim->updateNeighbors();
+    setCounters(state, *sim);
+}
+BENCHMARK(BM_Neighbors)->Apply(boidArgs);
+
+static void BM_Steering(benchmark::State& state) {
+    auto sim = createSimulation(state.range(0), state.range(1) / 10.0f, state.range(2), 3);
+    sim->updateNeighbors();
+    for (auto _ : state)
+        sim->updateSteering();
+    setCounters(state, *sim);
+}
+BENCHMARK(BM_Steering)->Apply(boidArgs);
+
+static void BM_Integration(benchmark::State& state) {
+    auto sim = createSimulation(state.range(0), 1.0f, 1.0f, 3);
+    for (auto _ : state)
+        sim->integrate(0.01f);
+    state.SetItemsProcessed(state.iterations() * sim->getState().size());
+}
+BENCHMARK(BM_Integration)->ArgName("boids")->RangeMultiplier(10)->Range(100, 100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Step(benchmark::State& state) {
+    auto sim = createSimulation(state.range(0), state.range(1) / 10.0f, state.range(2), 3);
+    for (auto _ : state)
+        sim->step(0.01f);
+    setCounters(state, *sim);
+}
+BENCHMARK(BM_Step)->Apply(boidArgs);
+
+static void BM_StepPairs(benchmark::State& state) {
+    auto sim = createSimulation(state.range(0), state.range(1) / 10.0f, state.range(2), 3);
+    sim->setPairMode(true);
+    for (auto _ : state)
+        sim->step(0.01f);
+    setCounters(state, *sim);
+}
+BENCHMARK(BM_StepPairs)->Apply(boidArgs);
+
+// Boids start in random order, order 0 keeps it and 1/2 sort them along a Morton/Hilbert curve every 16 steps
+static void BM_StepOrder(benchmark::State& state) {
+    auto sim = createSimulation(state.range(0), 1.0f, 4.0f, 3);
+    sim->setOrder(BoidOrder(state.range(1)), 16);
+    for (auto _ : state)
+        sim->step(0.01f);
+    setCounters(state, *sim);
+}
+BENCHMARK(BM_StepOrder)->ArgNames({"boids", "order"})->ArgsProduct({{10000, 100000}, {0, 1, 2}})->Unit(benchmark::kMicrosecond);
+
+// Dense flock, with and without level of detail
+static void BM_StepLod(benchmark::State& state) {
+    auto sim = createSimulation(state.range(0), 1.0f, state.range(1), 3);
+    LodSettings lod;
+    lod.enabled = state.range(2);
+    sim->setLod(lod);
+    for (auto _ : state)
+        sim->step(0.01f);
+    setCounters(state, *sim);
+    state.counters["lod"] = benchmark::Counter(float(sim->getNeighbors().getNumLod()) / std::max(sim->getState().size(), 1u));
+}
+BENCHMARK(BM_StepLod)->ArgNames({"boids", "density", "lod"})->ArgsProduct({{10000}, {4, 64}, {0, 1}})->Unit(benchmark::kMicrosecond);
+
+static void BM_StepThreads(benchmark::State& state) {
+    auto sim = createSimulation(state.range(0), 1.0f, 1.0f, 3, state.range(1));
+    for (auto _ : state)
+        sim->step(0.01f);
+    setCounters(state, *sim);
+}
+BENCHMARK(BM_StepThreads)
+    ->ArgNames({"boids", "threads"})
+    ->ArgsProduct({{10000, 100000}, {1, 2, 4, 8}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+//---------- Force field ----------//
+static void obstacleArgs(benchmark::internal::Benchmark* b) {
+    b->ArgName("obstacles");
+    b->Arg(0)->Arg(3)->Arg(10)->Arg(100);
+}
+
+// Forces evaluated directly from the sources
+static void BM_ForceFieldDirect(benchmark::State& state) {
+    Scene scene = generateScene(20.0f, 10.0f, state.range(0), 42);
+    CounterRng rng(1, 0);
+    float x[1024], y[1024];
+    for (int i = 0; i < 1024; i++) {
+        x[i] = (rng.uniform() - 0.5f) * 20.0f;
+        y[i] = (rng.uniform() - 0.5f) * 10.0f;
+    }
+    for (auto _ : state)
+        for (int i = 0; i < 1024; i++) {
+            float fx, fy;
+            getForceField(scene.sources, x[i], y[i], fx, fy);
+            benchmark::DoNotOptimize(fx);
+            benchmark::DoNotOptimize(fy);
+        }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_ForceFieldDirect)->Apply(obstacleArgs);
+
+// Forces evaluated directly from the sources, vectorized over the points
+static void BM_ForceFieldBatch(benchmark::State& state) {
+    Scene scene = generateScene(20.0f, 10.0f, state.range(0), 42);
+    ObstacleArrays obstacles;
+    obstacles.assign(scene.sources.obstacles);
+    CounterRng rng(1, 0);
+    float x[1024], y[1024], fx[1024], fy[1024];
+    for (int i = 0; i < 1024; i++) {
+        x[i] = (rng.uniform() - 0.5f) * 20.0f;
+        y[i] = (rng.uniform() - 0.5f) * 10.0f;
+    }
+    for (auto _ : state) {
+        getForceFieldBatch(scene.sources, obstacles, x, y, 1024, fx, fy);
+        benchmark::DoNotOptimize(fx);
+        benchmark::DoNotOptimize(fy);
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_ForceFieldBatch)->Apply(obstacleArgs);
+
+// Forces interpolated from the cached grid
+static void BM_ForceFieldSample(benchmark::State& state) {
+    Scene scene = generateScene(20.0f, 10.0f, state.range(0), 42);
+    Simulation sim;
+    sim.setForceFieldSources(scene.sources);
+    CounterRng rng(1, 0);
+    float x[1024], y[1024];
+    for (int i = 0; i < 1024; i++) {
+        x[i] = (rng.uniform() - 0.5f) * 20.0f;
+        y[i] = (rng.uniform() - 0.5f) * 10.0f;
+    }
+    for (auto _ : state)
+        for (int i = 0; i < 1024; i++) {
+            float fx, fy;
+            sim.getForceField().sample(x[i], y[i], fx, fy);
+            benchmark::DoNotOptimize(fx);
+            benchmark::DoNotOptimize(fy);
+        }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_ForceFieldSample)->Apply(obstacleArgs);
+
+// Full rebuild (the walls change at each iteration)
+static void BM_ForceFieldRebuild(benchmark::State& state) {
+    Scene scene = generateScene(state.range(1), state.range(1) / 2.0f, state.range(0), 42);
+    Simulation sim;
+    uint32_t i = 0;
+    for (auto _ : state) {
+        scene.sources.top += (i++ % 2) ? 0.001f : -0.001f;
+        sim.setForceFieldSources(scene.sources);
+    }
+    state.counters["cells"] = sim.getForceField().getWidth() * sim.getForceField().getHeight();
+}
+BENCHMARK(BM_ForceFieldRebuild)
+    ->ArgNames({"obstacles", "width"})
+    ->ArgsProduct({{0, 3, 10, 100}, {20, 100}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Incremental update (one obstacle moves at each iteration)
+static void BM_ForceFieldMove(benchmark::State& state) {
+    Scene scene = generateScene(20.0f, 10.0f, state.range(0), 42);
+    Simulation sim;
+    sim.setForceFieldSources(scene.sources);
+    uint32_t i = 0;
+    for (auto _ : state) {
+        scene.sources.obstacles[0].x += (i++ % 2) ? 0.1f : -0.1f;
+        sim.setForceFieldSources(scene.sources);
+    }
+}
+BENCHMARK(BM_ForceFieldMove)->ArgName("obstacles")->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+// Many obstacles with culling (cutoff and theta in tenths, zero to disable), rebuild or one obstacle moving at each iteration
+static void BM_ForceFieldCulling(benchmark::State& state) {
+    Scene scene = generateScene(40.0f, 20.0f, state.range(0), 42);
+    Simulation sim;
+    sim.setObstacleCulling({state.range(1) / 10.0f, state.range(2) / 10.0f});
+    sim.setForceFieldSources(scene.sources);
+    const bool move = state.range(3);
+    uint32_t i = 0;
+    for (auto _ : state) {
+        if (move)
+            scene.sources.obstacles[0].x += (i++ % 2) ? 0.1f : -0.1f;
+        else
+            scene.sources.top += (i++ % 2) ? 0.001f : -0.001f;
+        sim.setForceFieldSources(scene.sources);
+    }
+}
+BENCHMARK(BM_ForceFieldCulling)
+    ->ArgNames({"obstacles", "cutoff", "theta", "move"})
+    ->ArgsProduct({{100, 1000}, {0, 30}, {0, 5}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+//---------- Background ----------//
+static void BM_HeatMap(benchmark::State& state) {
+    Scene scene = generateScene(state.range(0), state.range(0) / 2.0f, 3, 42);
+    Simulation sim;
+    sim.setForceFieldSources(scene.sources);
+    const ForceFieldGrid& forceField = sim.getForceField();
+    std::vector<uint8_t> image(forceField.getWidth() * forceField.getHeight() * 4);
+    for (auto _ : state) {
+        drawForceField(forceField, image.data(), sim.getPool(), true);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * forceField.getWidth() * forceField.getHeight());
+}
+BENCHMARK(BM_HeatMap)->ArgName("width")->Arg(20)->Arg(100)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char** argv) {
+    // No frames are ended here, and the timers would be measured with the phases
+    Profiler::get().setEnabled(false);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
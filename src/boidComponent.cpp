@@ -5,27 +5,45 @@
 // By Breno Cunha Queiroz
 //--------------------------------------------------
 #include "boidComponent.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
 
 using namespace atta;
 namespace cmp = atta::component;
 
+#ifndef BOIDS_MAX_BOIDS
+#define BOIDS_MAX_BOIDS 131072
+#endif
+
+uint32_t getMaxBoids() {
+    // Can be changed at load time with the BOIDS_MAX_BOIDS environment variable
+    static uint32_t maxBoids = [] {
+        const char* env = std::getenv("BOIDS_MAX_BOIDS");
+        if (!env)
+            return uint32_t(BOIDS_MAX_BOIDS);
+        // The whole value must be a number from 1 to UINT32_MAX, the compile time value is used otherwise
+        char* end;
+        errno = 0;
+        long long value = std::strtoll(env, &end, 10);
+        if (end == env || *end != '\0' || errno == ERANGE || value <= 0 || value > UINT32_MAX) {
+            LOG_WARN("BoidComponent", "Invalid BOIDS_MAX_BOIDS [w]$0[], using [w]$1[]", env, BOIDS_MAX_BOIDS);
+            return uint32_t(BOIDS_MAX_BOIDS);
+        }
+        return uint32_t(value);
+    }();
+    return maxBoids;
+}
+
 template <>
 cmp::ComponentDescription& cmp::TypedComponentRegistry<BoidComponent>::getDescription() {
     static cmp::ComponentDescription desc = {"Boid",
                                              {{AttributeType::VECTOR_FLOAT32, offsetof(BoidComponent, velocity), "velocity"},
                                               {AttributeType::VECTOR_FLOAT32, offsetof(BoidComponent, acceleration), "acceleration"},
-                                              {AttributeType::CUSTOM, offsetof(BoidComponent, neighbors), "neighbors"}},
+                                              {AttributeType::UINT32, offsetof(BoidComponent, firstNeighbor), "firstNeighbor"},
+                                              {AttributeType::UINT32, offsetof(BoidComponent, numNeighbors), "numNeighbors"}},
                                              // Max instances
-                                             1024,
-                                             // Serialize
-                                             {{"neighbors",
-                                               [](std::ostream& os, void* data) {
-                                                   // Do not serialize neighbors
-                                               }}},
-                                             // Deserialize
-                                             {{"neighbors", [](std::istream& is, void* data) {
-                                                   // Do not deserialize neighbors
-                                               }}}};
+                                             getMaxBoids()};
 
     return desc;
 }
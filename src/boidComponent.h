@@ -12,19 +12,29 @@ namespace cmp = atta::component;
 
 struct BoidComponent final : public cmp::Component {
     /// Boid velocity
-    /** This velocity will remain the same at during boidScript computations and can be accessed by other boids.
-     * This is updated at the end of each step by the projectScript
+    /** Copied from the simulation state by the projectScript after the steps of each frame. The steering reads the positions and
+     * velocities of the state and only writes the accelerations, which are integrated after all boids were steered. The UI reads the
+     * snapshot published after the steps (see SnapshotBuffer) instead of the components
      **/
     atta::vec2 velocity;
     /// Boid acceleration
-    /** The acceleration is calculated by the boidScript, the projectScript updates all velocities at the end of each step **/
+    /** Computed in bulk by the projectScript (see steering.h) **/
     atta::vec2 acceleration;
-    /// Neighbors
-    /** Updated by projectScript before all boidScripts **/
-    std::vector<cmp::EntityId> neighbors;
+    /// First neighbor
+    /** Offset in the neighbor list owned by the projectScript, updated before the steering computation **/
+    uint32_t firstNeighbor;
+    /// Number of neighbors
+    uint32_t numNeighbors;
 };
 ATTA_REGISTER_COMPONENT(BoidComponent);
 template <>
 cmp::ComponentDescription& cmp::TypedComponentRegistry<BoidComponent>::getDescription();
 
+/// Maximum number of boids
+/** Number of BoidComponent instances allocated in the component pool when the project is loaded. Set at compile time by
+ * BOIDS_MAX_BOIDS and can be changed at load time with the BOIDS_MAX_BOIDS environment variable (an invalid value is reported and
+ * ignored). The pool is not grown while running
+ **/
+uint32_t getMaxBoids();
+
 #endif // BOID_COMPONENT_H
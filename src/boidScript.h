@@ -14,14 +14,6 @@ namespace scr = atta::script;
 class BoidScript : public scr::Script {
   public:
     void update(cmp::Entity entity, float dt) override;
-
-  private:
-    atta::vec2 collisionAvoidance(cmp::Entity entity, const std::vector<atta::vec2>& neighbourVecs);
-    atta::vec2 velocityMatching(cmp::Entity entity);
-    atta::vec2 flockCentering(cmp::Entity entity, const std::vector<atta::vec2>& neighbourVecs);
-    atta::vec2 obstacleAvoidance(cmp::Entity entity);
-
-    atta::vec2 getNeighbourVec(cmp::Entity entity, cmp::Entity neighbour);
 };
 
 ATTA_REGISTER_SCRIPT(BoidScript)
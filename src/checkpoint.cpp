@@ -0,0 +1,211 @@
+//--------------------------------------------------
+// Boids Basic
+// checkpoint.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "checkpoint.h"
+#include "mappedFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+static const char magic[8] = {'B', 'O', 'I', 'D', 'C', 'K', 'P', 'T'};
+static const uint32_t version = 4;
+static const uint32_t numArrays = 6;
+static const size_t alignment = 64;
+
+struct CheckpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t numBoids;
+    uint32_t numObstacles;
+    uint32_t headerSize;
+    RandomState random;
+    SimulationSettings settings;
+    float walls[4]; ///< Top, bottom, left, right
+    uint32_t fieldWidth;
+    uint32_t fieldHeight;
+    uint32_t fieldIncremental;
+    uint64_t obstaclesOffset;
+    uint64_t arraysOffset[numArrays]; ///< x, y, vx, vy, ax, ay
+    uint64_t fieldOffset[2];          ///< Cached obstacle forces (x, y)
+    uint64_t idsOffset;               ///< Id of each boid (the boids may be sorted, see Simulation::setOrder)
+    uint64_t boxesOffset;
+    uint32_t numBoxes;
+    ObstacleCulling culling; ///< Culling used by the cached force field
+    // Step options (the boid order and the neighbor sums depend on them, so they are restored to continue exactly)
+    uint32_t pairMode;
+    uint32_t order; ///< BoidOrder
+    uint32_t orderInterval;
+    uint32_t lodEnabled;
+    uint32_t lodThreshold;
+    float lodNearRadius;
+    uint32_t reserved; ///< Keeps the header size a multiple of 8
+};
+static_assert(sizeof(CheckpointHeader) == 232, "Unexpected checkpoint header size");
+static_assert(sizeof(DiskObstacle) == 12, "Unexpected obstacle size");
+static_assert(sizeof(BoxObstacle) == 20, "Unexpected box size");
+
+static size_t align(size_t offset) { return (offset + alignment - 1) / alignment * alignment; }
+
+bool saveCheckpoint(const std::string& filename, const Simulation& sim) {
+    const BoidState& state = sim.getState();
+    const ForceFieldGrid& field = sim.getForceField();
+    const ForceFieldSources& sources = field.getSources();
+    const uint32_t n = state.size();
+    const size_t numCells = size_t(field.getWidth()) * field.getHeight();
+
+    CheckpointHeader header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.numBoids = n;
+    header.numObstacles = sources.obstacles.size();
+    header.numBoxes = sources.boxes.size();
+    header.culling = field.getCulling();
+    header.pairMode = sim.getPairMode();
+    header.order = uint32_t(sim.getOrder());
+    header.orderInterval = sim.getOrderInterval();
+    header.lodEnabled = sim.getLod().enabled;
+    header.lodThreshold = sim.getLod().threshold;
+    header.lodNearRadius = sim.getLod().nearRadius;
+    header.headerSize = sizeof(header);
+    header.random = sim.getRandomState();
+    header.settings = sim.getSettings();
+    header.walls[0] = sources.top;
+    header.walls[1] = sources.bottom;
+    header.walls[2] = sources.left;
+    header.walls[3] = sources.right;
+    header.fieldWidth = field.getWidth();
+    header.fieldHeight = field.getHeight();
+    header.fieldIncremental = field.getNumIncremental();
+    header.obstaclesOffset = sizeof(header);
+    header.boxesOffset = align(header.obstaclesOffset + sources.obstacles.size() * sizeof(DiskObstacle));
+    size_t offset = align(header.boxesOffset + sources.boxes.size() * sizeof(BoxObstacle));
+    for (uint32_t a = 0; a < numArrays; a++) {
+        header.arraysOffset[a] = offset;
+        offset = align(offset + size_t(n) * sizeof(float));
+    }
+    for (uint32_t a = 0; a < 2; a++) {
+        header.fieldOffset[a] = offset;
+        offset = align(offset + numCells * sizeof(float));
+    }
+    header.idsOffset = offset;
+
+    // Ids in creation order if the state was resized without setting them
+    std::vector<uint32_t> ids = sim.getIds();
+    if (ids.size() != n) {
+        ids.resize(n);
+        for (uint32_t i = 0; i < n; i++)
+            ids[i] = i;
+    }
+
+    FILE* file = std::fopen(filename.c_str(), "wb");
+    if (!file)
+        return false;
+
+    // Write data and zero padding up to each offset
+    const char zeros[alignment] = {};
+    size_t written = 0;
+    auto write = [&](const void* data, size_t size, size_t at) {
+        while (written < at)
+            written += std::fwrite(zeros, 1, std::min(alignment, at - written), file);
+        written += std::fwrite(data, 1, size, file);
+    };
+    const float* arrays[numArrays] = {state.x.data(), state.y.data(), state.vx.data(), state.vy.data(), state.ax.data(), state.ay.data()};
+    write(&header, sizeof(header), 0);
+    write(sources.obstacles.data(), sources.obstacles.size() * sizeof(DiskObstacle), header.obstaclesOffset);
+    write(sources.boxes.data(), sources.boxes.size() * sizeof(BoxObstacle), header.boxesOffset);
+    for (uint32_t a = 0; a < numArrays; a++)
+        write(arrays[a], size_t(n) * sizeof(float), header.arraysOffset[a]);
+    write(field.getForcesX().data(), numCells * sizeof(float), header.fieldOffset[0]);
+    write(field.getForcesY().data(), numCells * sizeof(float), header.fieldOffset[1]);
+    write(ids.data(), size_t(n) * sizeof(uint32_t), header.idsOffset);
+
+    bool ok = written == header.idsOffset + size_t(n) * sizeof(uint32_t);
+    return std::fclose(file) == 0 && ok;
+}
+
+bool loadCheckpoint(const std::string& filename, Simulation& sim) {
+    MappedFile file;
+    if (!file.open(filename))
+        return false;
+
+    // Validate
+    CheckpointHeader header;
+    if (file.getSize() < sizeof(header))
+        return false;
+    std::memcpy(&header, file.getData(), sizeof(header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version || header.headerSize != sizeof(header))
+        return false;
+    if (header.order > uint32_t(BoidOrder::HILBERT))
+        return false;
+    // Each array must be inside the file (checked as size <= fileSize - offset, so a large offset can not overflow the sum)
+    const uint64_t fileSize = file.getSize();
+    auto inFile = [fileSize](uint64_t offset, uint64_t count, uint64_t elementSize) {
+        return offset <= fileSize && count <= (fileSize - offset) / elementSize;
+    };
+    if (!inFile(header.obstaclesOffset, header.numObstacles, sizeof(DiskObstacle)))
+        return false;
+    if (!inFile(header.boxesOffset, header.numBoxes, sizeof(BoxObstacle)))
+        return false;
+    for (uint32_t a = 0; a < numArrays; a++)
+        if (!inFile(header.arraysOffset[a], header.numBoids, sizeof(float)))
+            return false;
+    const uint64_t numCells = uint64_t(header.fieldWidth) * header.fieldHeight;
+    for (uint32_t a = 0; a < 2; a++)
+        if (!inFile(header.fieldOffset[a], numCells, sizeof(float)))
+            return false;
+    if (!inFile(header.idsOffset, header.numBoids, sizeof(uint32_t)))
+        return false;
+
+    // Ids must be a permutation of the boid indices
+    std::vector<uint32_t> ids(header.numBoids);
+    std::memcpy(ids.data(), file.getData() + header.idsOffset, size_t(header.numBoids) * sizeof(uint32_t));
+    std::vector<bool> found(header.numBoids, false);
+    for (uint32_t id : ids) {
+        if (id >= header.numBoids || found[id])
+            return false;
+        found[id] = true;
+    }
+
+    // Settings, random state, walls and obstacles
+    ForceFieldSources sources;
+    sources.top = header.walls[0];
+    sources.bottom = header.walls[1];
+    sources.left = header.walls[2];
+    sources.right = header.walls[3];
+    sources.obstacles.resize(header.numObstacles);
+    std::memcpy(sources.obstacles.data(), file.getData() + header.obstaclesOffset, header.numObstacles * sizeof(DiskObstacle));
+    sources.boxes.resize(header.numBoxes);
+    std::memcpy(sources.boxes.data(), file.getData() + header.boxesOffset, header.numBoxes * sizeof(BoxObstacle));
+    sim.setSettings(header.settings);
+    sim.setRandomState(header.random);
+    sim.setPairMode(header.pairMode);
+    sim.setOrder(BoidOrder(header.order), header.orderInterval);
+    LodSettings lod;
+    lod.enabled = header.lodEnabled;
+    lod.threshold = header.lodThreshold;
+    lod.nearRadius = header.lodNearRadius;
+    sim.setLod(lod);
+
+    // Cached force field (rebuilt if the grid size does not match)
+    ForceFieldGrid& field = sim.getForceField();
+    sim.setObstacleCulling(header.culling);
+    uint32_t width = std::max(sources.right - sources.left, 0.0f) * ForceFieldGrid::resolution;
+    uint32_t height = std::max(sources.top - sources.bottom, 0.0f) * ForceFieldGrid::resolution;
+    if (width == header.fieldWidth && height == header.fieldHeight)
+        field.restore(sources, reinterpret_cast<const float*>(file.getData() + header.fieldOffset[0]),
+                      reinterpret_cast<const float*>(file.getData() + header.fieldOffset[1]), header.fieldIncremental);
+    else
+        sim.setForceFieldSources(sources);
+
+    // Boids
+    BoidState& state = sim.getState();
+    state.resize(header.numBoids);
+    float* arrays[numArrays] = {state.x.data(), state.y.data(), state.vx.data(), state.vy.data(), state.ax.data(), state.ay.data()};
+    for (uint32_t a = 0; a < numArrays; a++)
+        std::memcpy(arrays[a], file.getData() + header.arraysOffset[a], size_t(header.numBoids) * sizeof(float));
+    sim.setIds(ids.data());
+    return true;
+}
@@ -0,0 +1,25 @@
+//--------------------------------------------------
+// Boids Basic
+// checkpoint.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+#include "simulation.h"
+#include <string>
+
+/// Write simulation checkpoint
+/** Versioned binary file with the state of all boids, random generator state, settings, step options (pair mode, boid order and level
+ * of detail), walls, obstacles and the cached force field.
+ * Each array is stored contiguously (64 byte aligned), so restoring is one copy per array from the memory mapped file
+ **/
+bool saveCheckpoint(const std::string& filename, const Simulation& sim);
+
+/// Restore simulation checkpoint
+/** Returns false if the file could not be read or is not a valid checkpoint (the simulation is not changed in this case). The
+ * simulation continues exactly as if it was never stopped
+ **/
+bool loadCheckpoint(const std::string& filename, Simulation& sim);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,78 @@
+//--------------------------------------------------
+// Boids Basic
+// flockMetrics.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "flockMetrics.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+uint32_t FlockAnalyzer::find(uint32_t i) {
+    while (_parent[i] != i) {
+        _parent[i] = _parent[_parent[i]];
+        i = _parent[i];
+    }
+    return i;
+}
+
+FlockMetrics FlockAnalyzer::analyze(const BoidState& state, float radius) {
+    FlockMetrics metrics;
+    const uint32_t n = state.size();
+    if (n == 0)
+        return metrics;
+
+    // Polarization
+    float sumX = 0.0f, sumY = 0.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        float vel = std::sqrt(state.vx[i] * state.vx[i] + state.vy[i] * state.vy[i]);
+        if (vel > 0.0f) {
+            sumX += state.vx[i] / vel;
+            sumY += state.vy[i] / vel;
+        }
+    }
+    metrics.polarization = std::sqrt(sumX * sumX + sumY * sumY) / n;
+
+    // Visit each pair within radius once, joining clusters and keeping the nearest neighbor of both boids
+    _grid.build(state.x.data(), state.y.data(), n, radius);
+    _parent.resize(n);
+    _size.assign(n, 1);
+    _nearest2.assign(n, std::numeric_limits<float>::infinity());
+    for (uint32_t i = 0; i < n; i++)
+        _parent[i] = i;
+    for (uint32_t i = 0; i < n; i++) {
+        _candidates.clear();
+        _grid.queryForward(state.x.data(), state.y.data(), i, radius, _candidates);
+        for (const GridNeighbor& c : _candidates) {
+            _nearest2[i] = std::min(_nearest2[i], c.d2);
+            _nearest2[c.index] = std::min(_nearest2[c.index], c.d2);
+            uint32_t a = find(i), b = find(c.index);
+            if (a == b)
+                continue;
+            if (_size[a] < _size[b])
+                std::swap(a, b);
+            _parent[b] = a;
+            _size[a] += _size[b];
+        }
+    }
+
+    // Clusters and nearest neighbor distance
+    uint32_t numClusters = 0, largest = 0, numIsolated = 0;
+    double sumNearest = 0.0;
+    for (uint32_t i = 0; i < n; i++) {
+        if (_parent[i] == i) {
+            numClusters++;
+            largest = std::max(largest, _size[i]);
+        }
+        if (std::isinf(_nearest2[i]))
+            numIsolated++;
+        else
+            sumNearest += std::sqrt(_nearest2[i]);
+    }
+    metrics.numClusters = numClusters;
+    metrics.largestCluster = float(largest) / n;
+    metrics.nearestNeighbor = numIsolated < n ? sumNearest / (n - numIsolated) : 0.0f;
+    metrics.isolated = float(numIsolated) / n;
+    return metrics;
+}
@@ -0,0 +1,39 @@
+//--------------------------------------------------
+// Boids Basic
+// flockMetrics.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef FLOCK_METRICS_H
+#define FLOCK_METRICS_H
+#include "spatialGrid.h"
+#include "steering.h"
+
+/// Flock metrics of one state
+struct FlockMetrics {
+    float polarization = 0.0f;    ///< Norm of the mean direction of the boids (1 when all boids fly in the same direction)
+    float numClusters = 0.0f;     ///< Groups of boids connected by distances smaller than the radius
+    float largestCluster = 0.0f;  ///< Fraction of the boids in the largest cluster
+    float nearestNeighbor = 0.0f; ///< Mean distance to the nearest neighbor of the boids that have a neighbor within the radius
+    float isolated = 0.0f;        ///< Fraction of the boids without neighbors within the radius
+};
+
+/// Compute flock metrics
+/** The neighbors within radius (usually the view radius) are found with a spatial grid, so the cost is the same as a neighbor search. All
+ * memory is reused between calls
+ **/
+class FlockAnalyzer {
+  public:
+    FlockMetrics analyze(const BoidState& state, float radius);
+
+  private:
+    uint32_t find(uint32_t i);
+
+    SpatialGrid _grid;
+    std::vector<GridNeighbor> _candidates;
+    std::vector<uint32_t> _parent; ///< Union-find of the clusters
+    std::vector<uint32_t> _size;
+    std::vector<float> _nearest2; ///< Squared distance to the nearest neighbor
+};
+
+#endif // FLOCK_METRICS_H
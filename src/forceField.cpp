@@ -5,71 +5,275 @@
 // By Breno Cunha Queiroz
 //--------------------------------------------------
 #include "forceField.h"
-#include <atta/component/components/mesh.h>
-#include <atta/component/components/relationship.h>
-#include <atta/component/components/transform.h>
-
-namespace cmp = atta::component;
-
-// Fixed entities
-#include "common.h"
-
-atta::vec2 getForceField(atta::vec2 position) {
-    // Walls
-    static cmp::Transform* tw = topWall.get<cmp::Transform>();
-    static cmp::Transform* bw = bottomWall.get<cmp::Transform>();
-    static cmp::Transform* lw = leftWall.get<cmp::Transform>();
-    static cmp::Transform* rw = rightWall.get<cmp::Transform>();
-
-    atta::vec2 forceField;
-
-    // Deal with fixed walls
-    if (tw) // Top wall
-    {
-        float dist = tw->position.y - position.y;
-        atta::vec2 normal(0, -1);
-        forceField += dist > 0.05f ? normal / (dist * dist) : normal * 1000.0f;
-    }
-    if (bw) // Bottom wall
-    {
-        float dist = position.y - bw->position.y;
-        atta::vec2 normal(0, 1);
-        forceField += dist > 0.05f ? normal / (dist * dist) : normal * 1000.0f;
-    }
-    if (lw) // Left wall
-    {
-        float dist = position.x - lw->position.x;
-        atta::vec2 normal(1, 0);
-        forceField += dist > 0.05f ? normal / (dist * dist) : normal * 1000.0f;
-    }
-    if (rw) // Right wall
-    {
-        float dist = rw->position.x - position.x;
-        atta::vec2 normal(-1, 0);
-        forceField += dist > 0.05f ? normal / (dist * dist) : normal * 1000.0f;
-    }
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+static float wallForce(float dist) { return dist > 0.05f ? 1.0f / (dist * dist) : 1000.0f; }
+
+void getWallsForce(const ForceFieldSources& sources, float x, float y, float& fx, float& fy) {
+    fy -= wallForce(sources.top - y);    // Top wall
+    fy += wallForce(y - sources.bottom); // Bottom wall
+    fx += wallForce(x - sources.left);   // Left wall
+    fx -= wallForce(sources.right - x);  // Right wall
+}
+
+static constexpr float noLimit = std::numeric_limits<float>::infinity();
+
+static void addDiskForce(float ox, float oy, float radius, float limit2, float x, float y, float& fx, float& fy) {
+    float dx = x - ox;
+    float dy = y - oy;
+    float d2 = dx * dx + dy * dy;
+    if (d2 == 0.0f || d2 > limit2)
+        return; // No direction at the obstacle center
+
+    // 0.4 * normalize(d) * radius / |d|^2
+    float w = 0.4f * radius / (std::sqrt(d2) * d2);
+    fx += dx * w;
+    fy += dy * w;
+}
+
+// Same as a disk, from the closest point of the core segment (computed in the box frame)
+static void addBoxForce(float ox, float oy, float extentX, float extentY, float c, float s, float strength, float limit2, float x, float y,
+                        float& fx, float& fy) {
+    float dx = x - ox;
+    float dy = y - oy;
+    float lx = c * dx + s * dy;
+    float ly = c * dy - s * dx;
+    float qx = lx - std::clamp(lx, -extentX, extentX);
+    float qy = ly - std::clamp(ly, -extentY, extentY);
+    float d2 = qx * qx + qy * qy;
+    if (d2 == 0.0f || d2 > limit2)
+        return; // Inside the core
+
+    float w = 0.4f * strength / (std::sqrt(d2) * d2);
+    fx += (c * qx - s * qy) * w;
+    fy += (s * qx + c * qy) * w;
+}
+
+// Strength (smaller side) and core half extents of a box
+static float getBoxCore(const BoxObstacle& box, float& extentX, float& extentY) {
+    const float side = std::min(std::abs(box.width), std::abs(box.height));
+    extentX = (std::abs(box.width) - side) * 0.5f;
+    extentY = (std::abs(box.height) - side) * 0.5f;
+    return side;
+}
+
+void getObstacleForce(const DiskObstacle& obstacle, float x, float y, float& fx, float& fy) {
+    addDiskForce(obstacle.x, obstacle.y, obstacle.radius, noLimit, x, y, fx, fy);
+}
+
+void getBoxForce(const BoxObstacle& box, float x, float y, float& fx, float& fy) {
+    float extentX, extentY;
+    float strength = getBoxCore(box, extentX, extentY);
+    addBoxForce(box.x, box.y, extentX, extentY, std::cos(box.angle), std::sin(box.angle), strength, noLimit, x, y, fx, fy);
+}
+
+void getForceField(const ForceFieldSources& sources, float x, float y, float& fx, float& fy) {
+    fx = fy = 0.0f;
+    getWallsForce(sources, x, y, fx, fy);
+    for (const DiskObstacle& obstacle : sources.obstacles)
+        getObstacleForce(obstacle, x, y, fx, fy);
+    for (const BoxObstacle& box : sources.boxes)
+        getBoxForce(box, x, y, fx, fy);
+}
+
+//---------- Batch ----------//
+void ObstacleArrays::assign(const std::vector<DiskObstacle>& disks, const std::vector<BoxObstacle>& boxes, float cutoff) {
+    clear();
+    for (const DiskObstacle& disk : disks)
+        addDisk(disk, cutoff);
+    for (const BoxObstacle& box : boxes)
+        addBox(box, cutoff);
+}
+
+void ObstacleArrays::clear() {
+    for (std::vector<float>* v : {&x, &y, &radius, &extentX, &extentY, &cos, &sin, &limit2})
+        v->clear();
+    shape.clear();
+    hasCutoff = hasBoxes = false;
+}
+
+void ObstacleArrays::addDisk(const DiskObstacle& disk, float cutoff) {
+    x.push_back(disk.x);
+    y.push_back(disk.y);
+    radius.push_back(disk.radius);
+    shape.push_back(OBSTACLE_DISK);
+    extentX.push_back(0.0f);
+    extentY.push_back(0.0f);
+    cos.push_back(1.0f);
+    sin.push_back(0.0f);
+    limit2.push_back(cutoff > 0.0f ? cutoff * cutoff : noLimit);
+    hasCutoff |= cutoff > 0.0f;
+}
+
+void ObstacleArrays::addBox(const BoxObstacle& box, float cutoff) {
+    float ex, ey;
+    x.push_back(box.x);
+    y.push_back(box.y);
+    radius.push_back(getBoxCore(box, ex, ey));
+    shape.push_back(OBSTACLE_BOX);
+    extentX.push_back(ex);
+    extentY.push_back(ey);
+    cos.push_back(std::cos(box.angle));
+    sin.push_back(std::sin(box.angle));
+    limit2.push_back(cutoff > 0.0f ? cutoff * cutoff : noLimit);
+    hasCutoff |= cutoff > 0.0f;
+    hasBoxes = true;
+}
+
+void ObstacleArrays::add(const ObstacleArrays& other, uint32_t k, float cutoff) {
+    x.push_back(other.x[k]);
+    y.push_back(other.y[k]);
+    radius.push_back(other.radius[k]);
+    shape.push_back(other.shape[k]);
+    extentX.push_back(other.extentX[k]);
+    extentY.push_back(other.extentY[k]);
+    cos.push_back(other.cos[k]);
+    sin.push_back(other.sin[k]);
+    limit2.push_back(cutoff > 0.0f ? cutoff * cutoff : noLimit);
+    hasCutoff |= cutoff > 0.0f;
+    hasBoxes |= other.shape[k] == OBSTACLE_BOX;
+}
+
+void ObstacleArrays::getBounds(uint32_t k, float& minX, float& minY, float& maxX, float& maxY) const {
+    const float hx = std::abs(cos[k]) * extentX[k] + std::abs(sin[k]) * extentY[k];
+    const float hy = std::abs(sin[k]) * extentX[k] + std::abs(cos[k]) * extentY[k];
+    minX = x[k] - hx;
+    maxX = x[k] + hx;
+    minY = y[k] - hy;
+    maxY = y[k] + hy;
+}
+
+void addObstacleForce(const ObstacleArrays& o, uint32_t k, float x, float y, float limit2, float& fx, float& fy) {
+    if (o.shape[k] == OBSTACLE_DISK)
+        addDiskForce(o.x[k], o.y[k], o.radius[k], limit2, x, y, fx, fy);
+    else
+        addBoxForce(o.x[k], o.y[k], o.extentX[k], o.extentY[k], o.cos[k], o.sin[k], o.radius[k], limit2, x, y, fx, fy);
+}
 
-    // Deal with dynamic obstacle
-    cmp::Relationship* obsr = obstacles.get<cmp::Relationship>();
-    for (cmp::EntityId eid : obsr->getChildren()) {
-        cmp::Entity obstacle{eid};
-        cmp::Mesh* obsM = obstacle.get<cmp::Mesh>();
-        cmp::Transform* obsT = obstacle.get<cmp::Transform>();
-        switch (obsM->sid.getId()) {
-        case "meshes/disk.obj"_sid:
-        case "meshes/sphere.obj"_sid: {
-            atta::vec2 distDir = atta::vec2(position) - atta::vec2(obsT->position);
-            float radius = obsT->scale.x;
-            forceField += 0.4f * (atta::normalize(distDir) * radius) / distDir.squareLength();
-            break;
+// Same operations as getObstacleForce for the disks, the contribution is zero at the obstacle center and beyond the cutoff
+#if defined(__AVX2__)
+template <bool Cutoff>
+static uint32_t addObstaclesForceSimd(const ObstacleArrays& obstacles, const float* x, const float* y, uint32_t n, float* fx, float* fy) {
+    const __m256 zero = _mm256_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 px = _mm256_loadu_ps(x + i);
+        const __m256 py = _mm256_loadu_ps(y + i);
+        __m256 ax = _mm256_loadu_ps(fx + i);
+        __m256 ay = _mm256_loadu_ps(fy + i);
+        for (uint32_t k = 0; k < obstacles.size(); k++) {
+            if (obstacles.shape[k] != OBSTACLE_DISK)
+                continue;
+            __m256 dx = _mm256_sub_ps(px, _mm256_set1_ps(obstacles.x[k]));
+            __m256 dy = _mm256_sub_ps(py, _mm256_set1_ps(obstacles.y[k]));
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            __m256 w = _mm256_div_ps(_mm256_set1_ps(0.4f * obstacles.radius[k]), _mm256_mul_ps(_mm256_sqrt_ps(d2), d2));
+            w = _mm256_and_ps(w, _mm256_cmp_ps(d2, zero, _CMP_NEQ_OQ));
+            if constexpr (Cutoff)
+                w = _mm256_and_ps(w, _mm256_cmp_ps(d2, _mm256_set1_ps(obstacles.limit2[k]), _CMP_LE_OQ));
+            ax = _mm256_add_ps(ax, _mm256_mul_ps(dx, w));
+            ay = _mm256_add_ps(ay, _mm256_mul_ps(dy, w));
+        }
+        _mm256_storeu_ps(fx + i, ax);
+        _mm256_storeu_ps(fy + i, ay);
+    }
+    return i;
+}
+#elif defined(__SSE2__)
+template <bool Cutoff>
+static uint32_t addObstaclesForceSimd(const ObstacleArrays& obstacles, const float* x, const float* y, uint32_t n, float* fx, float* fy) {
+    const __m128 zero = _mm_setzero_ps();
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m128 px = _mm_loadu_ps(x + i);
+        const __m128 py = _mm_loadu_ps(y + i);
+        __m128 ax = _mm_loadu_ps(fx + i);
+        __m128 ay = _mm_loadu_ps(fy + i);
+        for (uint32_t k = 0; k < obstacles.size(); k++) {
+            if (obstacles.shape[k] != OBSTACLE_DISK)
+                continue;
+            __m128 dx = _mm_sub_ps(px, _mm_set1_ps(obstacles.x[k]));
+            __m128 dy = _mm_sub_ps(py, _mm_set1_ps(obstacles.y[k]));
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            __m128 w = _mm_div_ps(_mm_set1_ps(0.4f * obstacles.radius[k]), _mm_mul_ps(_mm_sqrt_ps(d2), d2));
+            w = _mm_and_ps(w, _mm_cmpneq_ps(d2, zero));
+            if constexpr (Cutoff)
+                w = _mm_and_ps(w, _mm_cmple_ps(d2, _mm_set1_ps(obstacles.limit2[k])));
+            ax = _mm_add_ps(ax, _mm_mul_ps(dx, w));
+            ay = _mm_add_ps(ay, _mm_mul_ps(dy, w));
         }
-        case "meshes/plane.obj"_sid:
-        case "meshes/box.obj"_sid:
-            break;
-        default:
-            LOG_WARN("BoidScript", "Trying to avoid unknown obstacle [w]$0[]", obsM->sid.getString());
+        _mm_storeu_ps(fx + i, ax);
+        _mm_storeu_ps(fy + i, ay);
+    }
+    return i;
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+template <bool Cutoff>
+static uint32_t addObstaclesForceSimd(const ObstacleArrays& obstacles, const float* x, const float* y, uint32_t n, float* fx, float* fy) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const float32x4_t px = vld1q_f32(x + i);
+        const float32x4_t py = vld1q_f32(y + i);
+        float32x4_t ax = vld1q_f32(fx + i);
+        float32x4_t ay = vld1q_f32(fy + i);
+        for (uint32_t k = 0; k < obstacles.size(); k++) {
+            if (obstacles.shape[k] != OBSTACLE_DISK)
+                continue;
+            float32x4_t dx = vsubq_f32(px, vdupq_n_f32(obstacles.x[k]));
+            float32x4_t dy = vsubq_f32(py, vdupq_n_f32(obstacles.y[k]));
+            float32x4_t d2 = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+            float32x4_t w = vdivq_f32(vdupq_n_f32(0.4f * obstacles.radius[k]), vmulq_f32(vsqrtq_f32(d2), d2));
+            w = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(w), vmvnq_u32(vceqq_f32(d2, zero))));
+            if constexpr (Cutoff)
+                w = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(w), vcleq_f32(d2, vdupq_n_f32(obstacles.limit2[k]))));
+            ax = vaddq_f32(ax, vmulq_f32(dx, w));
+            ay = vaddq_f32(ay, vmulq_f32(dy, w));
         }
+        vst1q_f32(fx + i, ax);
+        vst1q_f32(fy + i, ay);
     }
-    return forceField;
+    return i;
 }
+#else
+template <bool Cutoff>
+static uint32_t addObstaclesForceSimd(const ObstacleArrays&, const float*, const float*, uint32_t, float*, float*) { return 0; }
+#endif
 
+void addObstaclesForceBatch(const ObstacleArrays& obstacles, const float* x, const float* y, uint32_t n, float* fx, float* fy) {
+    const ObstacleArrays& o = obstacles;
+    uint32_t vectorized = o.hasCutoff ? addObstaclesForceSimd<true>(o, x, y, n, fx, fy) : addObstaclesForceSimd<false>(o, x, y, n, fx, fy);
+
+    // Points that don't fill a vector
+    for (uint32_t i = vectorized; i < n; i++)
+        for (uint32_t k = 0; k < o.size(); k++)
+            if (o.shape[k] == OBSTACLE_DISK)
+                addDiskForce(o.x[k], o.y[k], o.radius[k], o.limit2[k], x[i], y[i], fx[i], fy[i]);
+
+    // Boxes
+    if (o.hasBoxes)
+        for (uint32_t k = 0; k < o.size(); k++)
+            if (o.shape[k] == OBSTACLE_BOX)
+                for (uint32_t i = 0; i < n; i++)
+                    addBoxForce(o.x[k], o.y[k], o.extentX[k], o.extentY[k], o.cos[k], o.sin[k], o.radius[k], o.limit2[k], x[i], y[i], fx[i],
+                                fy[i]);
+}
+
+void getForceFieldBatch(const ForceFieldSources& sources, const ObstacleArrays& obstacles, const float* x, const float* y, uint32_t n,
+                        float* fx, float* fy) {
+    for (uint32_t i = 0; i < n; i++) {
+        fx[i] = fy[i] = 0.0f;
+        getWallsForce(sources, x[i], y[i], fx[i], fy[i]);
+    }
+    addObstaclesForceBatch(obstacles, x, y, n, fx, fy);
+}
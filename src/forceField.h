@@ -6,7 +6,103 @@
 //--------------------------------------------------
 #ifndef FORCE_FIELD_H
 #define FORCE_FIELD_H
+#include <cstdint>
+#include <vector>
 
-atta::vec2 getForceField(atta::vec2 position);
+/// Disk obstacle
+struct DiskObstacle {
+    float x;
+    float y;
+    float radius;
 
-#endif// FORCE_FIELD_H
+    bool operator==(const DiskObstacle& o) const { return x == o.x && y == o.y && radius == o.radius; }
+    bool operator!=(const DiskObstacle& o) const { return !(*this == o); }
+};
+
+/// Box obstacle (box and plane meshes)
+/** Pushes like a rectangle with rounded corners: the force points away from the closest point of the core segment (the box shrunk by
+ * half of its smaller side) and has the strength of a disk with radius equal to the smaller side, so a square box pushes like a disk with
+ * the same scale **/
+struct BoxObstacle {
+    float x;
+    float y;
+    float width;
+    float height;
+    float angle; ///< Rotation around z (rad)
+
+    bool operator==(const BoxObstacle& o) const {
+        return x == o.x && y == o.y && width == o.width && height == o.height && angle == o.angle;
+    }
+    bool operator!=(const BoxObstacle& o) const { return !(*this == o); }
+};
+
+/// Everything that generates the force field
+/** Extracted from the scene once per step by the projectScript **/
+struct ForceFieldSources {
+    float top, bottom, left, right; ///< Wall positions
+    std::vector<DiskObstacle> obstacles;
+    std::vector<BoxObstacle> boxes;
+};
+
+/// Force generated by the walls at (x, y)
+void getWallsForce(const ForceFieldSources& sources, float x, float y, float& fx, float& fy);
+
+/// Force generated by one obstacle at (x, y)
+void getObstacleForce(const DiskObstacle& obstacle, float x, float y, float& fx, float& fy);
+
+/// Force generated by one box at (x, y)
+void getBoxForce(const BoxObstacle& box, float x, float y, float& fx, float& fy);
+
+/// Force generated by walls and obstacles at (x, y)
+void getForceField(const ForceFieldSources& sources, float x, float y, float& fx, float& fy);
+
+//---------- Batch ----------//
+/// Obstacle shape
+enum ObstacleShape : uint8_t {
+    OBSTACLE_DISK = 0,
+    OBSTACLE_BOX = 1,
+};
+
+/// Obstacles in structure-of-arrays layout (see getForceFieldBatch)
+/** Boxes are stored as their core segment: center (x, y), half extents of the core and rotation. The radius is the strength of the
+ * obstacle (disk radius or smaller box side) **/
+struct ObstacleArrays {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> radius;
+    std::vector<uint8_t> shape; ///< ObstacleShape
+    std::vector<float> extentX; ///< Core half width (boxes only)
+    std::vector<float> extentY; ///< Core half height (boxes only)
+    std::vector<float> cos;     ///< Rotation (boxes only)
+    std::vector<float> sin;
+    std::vector<float> limit2; ///< Squared distance to the core beyond which the obstacle is ignored (infinity without cutoff)
+    bool hasCutoff = false;    ///< Some limit2 is finite
+    bool hasBoxes = false;
+
+    /// Disks followed by boxes, ignored beyond cutoff (no cutoff if zero)
+    void assign(const std::vector<DiskObstacle>& disks, const std::vector<BoxObstacle>& boxes = {}, float cutoff = 0.0f);
+    void clear();
+    void addDisk(const DiskObstacle& disk, float cutoff = 0.0f);
+    void addBox(const BoxObstacle& box, float cutoff = 0.0f);
+    /// Copy obstacle k of other with another cutoff
+    void add(const ObstacleArrays& other, uint32_t k, float cutoff = 0.0f);
+    uint32_t size() const { return x.size(); }
+
+    /// Bounds of the core of obstacle k (a point for disks)
+    void getBounds(uint32_t k, float& minX, float& minY, float& maxX, float& maxY) const;
+};
+
+/// Add the force generated by obstacle k at (x, y) to (fx, fy), ignored at squared distances to its core larger than limit2
+void addObstacleForce(const ObstacleArrays& obstacles, uint32_t k, float x, float y, float limit2, float& fx, float& fy);
+
+/// Add the force generated by the obstacles at n points to (fx, fy)
+/** Disks are vectorized over the points with AVX2, SSE2 or NEON, each disk is loaded once for every 8 (or 4) points. Boxes are
+ * computed after the disks, so without cutoff the result is the same as calling getObstacleForce for each disk and then getBoxForce for
+ * each box **/
+void addObstaclesForceBatch(const ObstacleArrays& obstacles, const float* x, const float* y, uint32_t n, float* fx, float* fy);
+
+/// Force generated by walls and obstacles at n points (same result as getForceField for each point)
+void getForceFieldBatch(const ForceFieldSources& sources, const ObstacleArrays& obstacles, const float* x, const float* y, uint32_t n,
+                        float* fx, float* fy);
+
+#endif // FORCE_FIELD_H
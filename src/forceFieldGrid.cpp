@@ -0,0 +1,233 @@
+//--------------------------------------------------
+// Boids Basic
+// forceFieldGrid.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "forceFieldGrid.h"
+#include "profiler.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// Rebuild from time to time to avoid accumulating rounding errors from incremental updates
+static constexpr uint32_t maxIncremental = 256;
+// Cells with smaller force change are not marked as dirty
+static constexpr float dirtyTolerance = 1e-4f;
+
+ForceFieldGrid::ForceFieldGrid() : _sources{}, _culling{}, _width(0), _height(0), _numIncremental(0), _tilesX(0), _tilesY(0) {}
+
+bool ForceFieldGrid::update(const ForceFieldSources& sources, ThreadPool& pool) {
+    uint32_t width = std::max(sources.right - sources.left, 0.0f) * resolution;
+    uint32_t height = std::max(sources.top - sources.bottom, 0.0f) * resolution;
+
+    // Walls changed or obstacles added/removed
+    if (width != _width || height != _height || sources.top != _sources.top || sources.bottom != _sources.bottom ||
+        sources.left != _sources.left || sources.right != _sources.right || sources.obstacles.size() != _sources.obstacles.size() ||
+        sources.boxes.size() != _sources.boxes.size() || _numIncremental >= maxIncremental) {
+        _sources = sources;
+        _width = width;
+        _height = height;
+        _bvh.build(_sources);
+        rebuild(pool);
+        return true;
+    }
+
+    // Obstacles moved
+    if (sources.obstacles != _sources.obstacles || sources.boxes != _sources.boxes) {
+        moveObstacles(_sources, sources, pool);
+        _sources.obstacles = sources.obstacles;
+        _sources.boxes = sources.boxes;
+        _numIncremental++;
+        return true;
+    }
+    return false;
+}
+
+void ForceFieldGrid::setCulling(const ObstacleCulling& culling, ThreadPool& pool) {
+    if (culling == _culling)
+        return;
+    _culling = culling;
+    if (!_fx.empty())
+        rebuild(pool);
+}
+
+void ForceFieldGrid::rebuild(ThreadPool& pool) {
+    PROFILE_SCOPE("force field rebuild");
+    _tilesX = (_width + tileSize - 1) / tileSize;
+    _tilesY = (_height + tileSize - 1) / tileSize;
+    _fx.assign(_width * _height, 0.0f);
+    _fy.assign(_width * _height, 0.0f);
+    _dirty.assign(_tilesX * _tilesY, true);
+    _numIncremental = 0;
+
+    _all.assign(_sources.obstacles, _sources.boxes);
+    _gathered.resize(pool.getNumThreads());
+    std::vector<double> evaluations(pool.getNumThreads(), 0.0);
+    pool.parallelFor(_tilesX * _tilesY, [&](uint32_t begin, uint32_t end, unsigned worker) {
+        for (uint32_t t = begin; t < end; t++) {
+            uint32_t ti = t % _tilesX * tileSize;
+            uint32_t tj = t / _tilesX * tileSize;
+            const ObstacleArrays& obstacles = getTileObstacles(t, worker);
+            addTileForces(t, obstacles, &_fx[tj * _width + ti], &_fy[tj * _width + ti], _width);
+            evaluations[worker] += double(std::min(ti + tileSize, _width) - ti) * (std::min(tj + tileSize, _height) - tj) * obstacles.size();
+        }
+    }, 1);
+    PROFILE_COUNTER_ADD("force field evaluations", std::accumulate(evaluations.begin(), evaluations.end(), 0.0));
+}
+
+void ForceFieldGrid::restore(const ForceFieldSources& sources, const float* fx, const float* fy, uint32_t numIncremental) {
+    _sources = sources;
+    _width = std::max(sources.right - sources.left, 0.0f) * resolution;
+    _height = std::max(sources.top - sources.bottom, 0.0f) * resolution;
+    _tilesX = (_width + tileSize - 1) / tileSize;
+    _tilesY = (_height + tileSize - 1) / tileSize;
+    _fx.assign(fx, fx + _width * _height);
+    _fy.assign(fy, fy + _width * _height);
+    _dirty.assign(_tilesX * _tilesY, true);
+    _numIncremental = numIncremental;
+    _bvh.build(_sources);
+}
+
+void ForceFieldGrid::moveObstacles(const ForceFieldSources& from, const ForceFieldSources& to, ThreadPool& pool) {
+    PROFILE_SCOPE("force field move");
+    _bvh.refit(to);
+
+    // Obstacles that moved, before and after
+    ObstacleArrays oldObstacles, newObstacles;
+    for (size_t k = 0; k < to.obstacles.size(); k++)
+        if (from.obstacles[k] != to.obstacles[k]) {
+            oldObstacles.addDisk(from.obstacles[k], _culling.cutoff);
+            newObstacles.addDisk(to.obstacles[k], _culling.cutoff);
+        }
+    for (size_t k = 0; k < to.boxes.size(); k++)
+        if (from.boxes[k] != to.boxes[k]) {
+            oldObstacles.addBox(from.boxes[k], _culling.cutoff);
+            newObstacles.addBox(to.boxes[k], _culling.cutoff);
+        }
+
+    // Tiles farther than the cutoff from the old and new position of all moved obstacles don't change
+    const float cutoff2 = _culling.cutoff * _culling.cutoff;
+    auto isNear = [&](uint32_t t) {
+        if (_culling.cutoff <= 0.0f)
+            return true;
+        float minX, minY, maxX, maxY;
+        getTileBounds(t, minX, minY, maxX, maxY);
+        for (const ObstacleArrays* obstacles : {&oldObstacles, &newObstacles})
+            for (uint32_t k = 0; k < obstacles->size(); k++) {
+                float oMinX, oMinY, oMaxX, oMaxY;
+                obstacles->getBounds(k, oMinX, oMinY, oMaxX, oMaxY);
+                float dx = std::max({oMinX - maxX, minX - oMaxX, 0.0f});
+                float dy = std::max({oMinY - maxY, minY - oMaxY, 0.0f});
+                if (dx * dx + dy * dy <= cutoff2)
+                    return true;
+            }
+        return false;
+    };
+
+    std::vector<double> evaluations(pool.getNumThreads(), 0.0);
+    pool.parallelFor(_tilesX * _tilesY, [&](uint32_t begin, uint32_t end, unsigned worker) {
+        for (uint32_t t = begin; t < end; t++) {
+            if (!isNear(t))
+                continue;
+            uint32_t ti = t % _tilesX * tileSize;
+            uint32_t tj = t / _tilesX * tileSize;
+            const uint32_t numCols = std::min(ti + tileSize, _width) - ti;
+            const uint32_t numRows = std::min(tj + tileSize, _height) - tj;
+
+            // Remove old contribution and add new one of the obstacles that moved
+            float oldX[tileSize * tileSize] = {}, oldY[tileSize * tileSize] = {}, newX[tileSize * tileSize] = {}, newY[tileSize * tileSize] = {};
+            addTileForces(t, oldObstacles, oldX, oldY, tileSize);
+            addTileForces(t, newObstacles, newX, newY, tileSize);
+            evaluations[worker] += 2.0 * numCols * numRows * newObstacles.size();
+            bool dirty = false;
+            for (uint32_t j = 0; j < numRows; j++)
+                for (uint32_t i = 0; i < numCols; i++) {
+                    float dx = newX[j * tileSize + i] - oldX[j * tileSize + i];
+                    float dy = newY[j * tileSize + i] - oldY[j * tileSize + i];
+                    _fx[(tj + j) * _width + ti + i] += dx;
+                    _fy[(tj + j) * _width + ti + i] += dy;
+                    dirty |= std::abs(dx) > dirtyTolerance || std::abs(dy) > dirtyTolerance;
+                }
+            if (dirty)
+                _dirty[t] = true;
+        }
+    }, 1);
+    PROFILE_COUNTER_ADD("force field evaluations", std::accumulate(evaluations.begin(), evaluations.end(), 0.0));
+}
+
+void ForceFieldGrid::addTileForces(uint32_t t, const ObstacleArrays& obstacles, float* fx, float* fy, uint32_t stride) const {
+    uint32_t ti = t % _tilesX * tileSize;
+    uint32_t tj = t / _tilesX * tileSize;
+    const uint32_t numCols = std::min(ti + tileSize, _width) - ti;
+    for (uint32_t j = tj; j < std::min(tj + tileSize, _height); j++) {
+        // One batch for each row of the tile
+        float x[tileSize], y[tileSize];
+        for (uint32_t i = 0; i < numCols; i++) {
+            x[i] = _sources.left + (ti + i + 0.5f) / resolution;
+            y[i] = _sources.bottom + (j + 0.5f) / resolution;
+        }
+        addObstaclesForceBatch(obstacles, x, y, numCols, fx + (j - tj) * stride, fy + (j - tj) * stride);
+    }
+}
+
+void ForceFieldGrid::getTileBounds(uint32_t t, float& minX, float& minY, float& maxX, float& maxY) const {
+    // Same cell centers as addTileForces
+    uint32_t ti = t % _tilesX * tileSize;
+    uint32_t tj = t / _tilesX * tileSize;
+    minX = _sources.left + (ti + 0.5f) / resolution;
+    minY = _sources.bottom + (tj + 0.5f) / resolution;
+    maxX = _sources.left + (std::min(ti + tileSize, _width) - 1 + 0.5f) / resolution;
+    maxY = _sources.bottom + (std::min(tj + tileSize, _height) - 1 + 0.5f) / resolution;
+}
+
+const ObstacleArrays& ForceFieldGrid::getTileObstacles(uint32_t t, unsigned worker) {
+    if (!_culling.isEnabled())
+        return _all;
+    float minX, minY, maxX, maxY;
+    getTileBounds(t, minX, minY, maxX, maxY);
+    ObstacleArrays& obstacles = _gathered[worker];
+    obstacles.clear();
+    _bvh.gather(_culling, minX, minY, maxX, maxY, obstacles);
+    return obstacles;
+}
+
+void ForceFieldGrid::sample(float x, float y, float& fx, float& fy) const {
+    fx = fy = 0.0f;
+    getWallsForce(_sources, x, y, fx, fy);
+
+    // Outside the grid
+    if (_width < 2 || _height < 2 || x < _sources.left || x > _sources.right || y < _sources.bottom || y > _sources.top) {
+        if (_culling.isEnabled())
+            _bvh.addForce(_culling, x, y, fx, fy);
+        else {
+            for (const DiskObstacle& obstacle : _sources.obstacles)
+                getObstacleForce(obstacle, x, y, fx, fy);
+            for (const BoxObstacle& box : _sources.boxes)
+                getBoxForce(box, x, y, fx, fy);
+        }
+        return;
+    }
+
+    // Bilinear interpolation between cell centers
+    float u = (x - _sources.left) * resolution - 0.5f;
+    float v = (y - _sources.bottom) * resolution - 0.5f;
+    uint32_t i = std::min(uint32_t(std::max(u, 0.0f)), _width - 2);
+    uint32_t j = std::min(uint32_t(std::max(v, 0.0f)), _height - 2);
+    float a = std::clamp(u - i, 0.0f, 1.0f);
+    float b = std::clamp(v - j, 0.0f, 1.0f);
+    uint32_t c = j * _width + i;
+    fx += (_fx[c] * (1 - a) + _fx[c + 1] * a) * (1 - b) + (_fx[c + _width] * (1 - a) + _fx[c + _width + 1] * a) * b;
+    fy += (_fy[c] * (1 - a) + _fy[c + 1] * a) * (1 - b) + (_fy[c + _width] * (1 - a) + _fy[c + _width + 1] * a) * b;
+}
+
+void ForceFieldGrid::getCellForce(uint32_t i, uint32_t j, float& fx, float& fy) const {
+    fx = _fx[j * _width + i];
+    fy = _fy[j * _width + i];
+    getWallsForce(_sources, _sources.left + (i + 0.5f) / resolution, _sources.bottom + (j + 0.5f) / resolution, fx, fy);
+}
+
+uint32_t ForceFieldGrid::getNumDirtyTiles() const { return std::count(_dirty.begin(), _dirty.end(), true); }
+
+void ForceFieldGrid::clearDirty() { std::fill(_dirty.begin(), _dirty.end(), false); }
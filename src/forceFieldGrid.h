@@ -0,0 +1,92 @@
+//--------------------------------------------------
+// Boids Basic
+// forceFieldGrid.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef FORCE_FIELD_GRID_H
+#define FORCE_FIELD_GRID_H
+#include "obstacleBvh.h"
+
+class ThreadPool;
+
+/// Cached force field
+/** The obstacle forces are stored at the center of each cell of a grid covering the area between the walls, and sampled with bilinear
+ * interpolation, so the cost of a lookup does not depend on the number of obstacles. The wall forces are cheap and very steep close to
+ * the walls, so they are always computed exactly.
+ *
+ * When an obstacle moves, only its old contribution is removed and the new one is added. The whole grid is rebuilt when the walls change
+ * or obstacles are added/removed. The grid is split in tiles that are updated in parallel, and the tiles whose forces changed are marked
+ * as dirty so the background only redraws them.
+ *
+ * With obstacle culling (see setCulling), each tile only evaluates the obstacles returned by an ObstacleBvh query for the tile, and
+ * moving obstacles only updates the tiles within the cutoff of their old or new position. The moved obstacles are always removed and
+ * added exactly, so with grouping (theta > 0) the error stays the one of the last rebuild.
+ **/
+class ForceFieldGrid {
+  public:
+    /// Cells per unit (same resolution as the background image)
+    static constexpr float resolution = 10.0f;
+
+    /// Tile size in cells
+    static constexpr uint32_t tileSize = 16;
+
+    ForceFieldGrid();
+
+    /// Update cached forces from the sources, returns true if something changed
+    bool update(const ForceFieldSources& sources, ThreadPool& pool);
+
+    /// Obstacle cutoff and grouping (the grid is rebuilt if they changed)
+    void setCulling(const ObstacleCulling& culling, ThreadPool& pool);
+    const ObstacleCulling& getCulling() const { return _culling; }
+
+    /// Force at (x, y), interpolated from the grid (computed directly outside the walls)
+    void sample(float x, float y, float& fx, float& fy) const;
+
+    /// Force at the center of cell (i, j)
+    void getCellForce(uint32_t i, uint32_t j, float& fx, float& fy) const;
+
+    const ForceFieldSources& getSources() const { return _sources; }
+    uint32_t getWidth() const { return _width; }
+    uint32_t getHeight() const { return _height; }
+
+    //---------- Tiles ----------//
+    uint32_t getNumTilesX() const { return _tilesX; }
+    uint32_t getNumTilesY() const { return _tilesY; }
+    /// If the forces of the tile changed since the last clearDirty
+    bool isTileDirty(uint32_t t) const { return _dirty[t]; }
+    uint32_t getNumDirtyTiles() const;
+    void clearDirty();
+
+    //---------- Checkpoint ----------//
+    const std::vector<float>& getForcesX() const { return _fx; }
+    const std::vector<float>& getForcesY() const { return _fy; }
+    uint32_t getNumIncremental() const { return _numIncremental; }
+    /// Restore cached forces saved with getForcesX/getForcesY (width*height values each)
+    void restore(const ForceFieldSources& sources, const float* fx, const float* fy, uint32_t numIncremental);
+
+  private:
+    void rebuild(ThreadPool& pool);
+    void moveObstacles(const ForceFieldSources& from, const ForceFieldSources& to, ThreadPool& pool);
+    /// Add obstacle forces at the cell centers of tile t (row stride in floats)
+    void addTileForces(uint32_t t, const ObstacleArrays& obstacles, float* fx, float* fy, uint32_t stride) const;
+    /// Cell center bounds of tile t
+    void getTileBounds(uint32_t t, float& minX, float& minY, float& maxX, float& maxY) const;
+    /// Obstacles for tile t (all obstacles without culling)
+    const ObstacleArrays& getTileObstacles(uint32_t t, unsigned worker);
+
+    ForceFieldSources _sources;
+    ObstacleCulling _culling;
+    ObstacleBvh _bvh;
+    ObstacleArrays _all;                   ///< All obstacles (used without culling)
+    std::vector<ObstacleArrays> _gathered; ///< Obstacles of the tile of each worker
+    uint32_t _width, _height;
+    std::vector<float> _fx; ///< Obstacle force x at cell centers
+    std::vector<float> _fy; ///< Obstacle force y at cell centers
+    uint32_t _numIncremental; ///< Incremental updates since last rebuild
+
+    uint32_t _tilesX, _tilesY;
+    std::vector<uint8_t> _dirty; ///< Dirty flag of each tile
+};
+
+#endif // FORCE_FIELD_GRID_H
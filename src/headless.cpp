@@ -0,0 +1,361 @@
+//--------------------------------------------------
+// Boids Basic
+// headless.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "checkpoint.h"
+#include "profiler.h"
+#include "sceneFile.h"
+#include "simulation.h"
+#include "trajectory.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// Headless runner: runs the simulation without atta, graphics or UI, so it can be used on servers without display/GPU
+static void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "Scene:\n"
+                "  --scene <file.atta>     Load walls, obstacles, settings, number of boids and dt from an atta project\n"
+                "  --size <width> <height> Generated scene size (default 20 10)\n"
+                "  --obstacles <k>         Number of random disks in the generated scene (default 3)\n"
+                "Simulation:\n"
+                "  --boids <m>             Number of boids (default: from scene file, or 1000)\n"
+                "  --steps <n>             Number of steps (default 1000)\n"
+                "  --dt <dt>               Time step (default: from scene file, or 0.01)\n"
+                "  --threads <t>           Number of threads (default: from scene file, or 1)\n"
+                "  --seed <s>              Random seed (default 42)\n"
+                "  --view-radius <r>       Override view radius\n"
+                "  --noise <n>             Override noise\n"
+                "  --max-neighbors <k>     Override maximum number of neighbors\n"
+                "  --pairs                 Visit each pair of neighbors once (without noise and maximum number of neighbors)\n"
+                "  --order <curve>         Sort boids in memory along a curve: none, morton or hilbert (default none)\n"
+                "  --order-interval <k>    Steps between sorts (default 16)\n"
+                "  --lod <k>               Level of detail for boids with more than k boids in the cells around them\n"
+                "  --lod-radius <f>        Close neighbors radius of the level of detail, relative to the view radius (default 0.25)\n"
+                "  --obstacle-cutoff <d>   Ignore obstacles farther than d (default: from checkpoint, or no cutoff)\n"
+                "  --obstacle-theta <t>    Replace groups of obstacles smaller than t times their distance by one disk (default: no grouping)\n"
+                "Output:\n"
+                "  --state <file.csv>      Final boid state (default state.csv)\n"
+                "  --timing <file.csv>     Time of each step (default timing.csv)\n"
+                "  --record <file>         Record trajectory of all boids (see trajectory.h)\n"
+                "  --trace <file.json>     Chrome trace of each step (requires BOIDS_ENABLE_PROFILER)\n"
+                "  --graph <file.dot>      Run each step as a task graph and save it (Graphviz) with the times of the last step\n"
+                "Checkpoint:\n"
+                "  --load-checkpoint <f>   Continue from checkpoint (boids, seed, settings, walls, obstacles, --pairs, --order and --lod;\n"
+                "                          --boids is ignored)\n"
+                "  --save-checkpoint <f>   Save checkpoint after the last step\n",
+                program);
+}
+
+int main(int argc, char** argv) {
+    std::string scenePath;
+    std::string statePath = "state.csv";
+    std::string timingPath = "timing.csv";
+    std::string recordPath;
+    std::string tracePath;
+    std::string graphPath;
+    std::string loadCheckpointPath, saveCheckpointPath;
+    float width = 20.0f, height = 10.0f;
+    long numObstacles = 3, numBoids = -1, numSteps = 1000, numThreads = -1, maxNeighbors = -1;
+    float dt = -1.0f, viewRadius = -1.0f, noise = -1.0f;
+    unsigned long long seed = 42;
+    bool pairMode = false;
+    BoidOrder order = BoidOrder::NONE;
+    long orderInterval = 16;
+    LodSettings lod;
+    bool stepOptions = false; ///< Pair mode, order or level of detail given (they come from the checkpoint when one is loaded)
+    float obstacleCutoff = -1.0f, obstacleTheta = -1.0f;
+
+    // Parse arguments
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&](int n = 1) {
+            if (i + n >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        // Numbers must use the whole value and be in range, the usage is printed otherwise
+        auto checkNumber = [&](const char* text, const char* end, bool inRange = true) {
+            if (end == text || *end != '\0' || errno == ERANGE || !inRange) {
+                std::fprintf(stderr, "Invalid value %s for %s\n", text, arg.c_str());
+                printUsage(argv[0]);
+                std::exit(1);
+            }
+        };
+        auto floatValue = [&](int n = 1) {
+            const char* text = value(n);
+            char* end;
+            errno = 0;
+            float number = std::strtof(text, &end);
+            checkNumber(text, end);
+            return number;
+        };
+        auto intValue = [&](int n = 1) {
+            const char* text = value(n);
+            char* end;
+            errno = 0;
+            long number = std::strtol(text, &end, 10);
+            checkNumber(text, end);
+            return number;
+        };
+        auto uintValue = [&](unsigned long long max = UINT32_MAX) {
+            const char* text = value();
+            char* end;
+            errno = 0;
+            unsigned long long number = std::strtoull(text, &end, 10);
+            checkNumber(text, std::strchr(text, '-') ? text : end, number <= max); // strtoull also accepts negative numbers
+            return number;
+        };
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--scene")
+            scenePath = value();
+        else if (arg == "--size") {
+            width = floatValue(2);
+            height = floatValue();
+        } else if (arg == "--obstacles")
+            numObstacles = intValue();
+        else if (arg == "--boids")
+            numBoids = uintValue();
+        else if (arg == "--steps")
+            numSteps = intValue();
+        else if (arg == "--dt")
+            dt = floatValue();
+        else if (arg == "--threads")
+            numThreads = intValue();
+        else if (arg == "--seed")
+            seed = uintValue(UINT64_MAX);
+        else if (arg == "--view-radius")
+            viewRadius = floatValue();
+        else if (arg == "--noise")
+            noise = floatValue();
+        else if (arg == "--max-neighbors")
+            maxNeighbors = intValue();
+        else if (arg == "--pairs")
+            pairMode = stepOptions = true;
+        else if (arg == "--order") {
+            stepOptions = true;
+            std::string curve = value();
+            if (curve == "none")
+                order = BoidOrder::NONE;
+            else if (curve == "morton")
+                order = BoidOrder::MORTON;
+            else if (curve == "hilbert")
+                order = BoidOrder::HILBERT;
+            else {
+                std::fprintf(stderr, "Unknown order %s\n", curve.c_str());
+                return 1;
+            }
+        } else if (arg == "--order-interval") {
+            orderInterval = intValue();
+            stepOptions = true;
+        } else if (arg == "--lod") {
+            lod.enabled = stepOptions = true;
+            lod.threshold = uintValue();
+        } else if (arg == "--lod-radius") {
+            lod.nearRadius = floatValue();
+            stepOptions = true;
+        }
+        else if (arg == "--obstacle-cutoff")
+            obstacleCutoff = floatValue();
+        else if (arg == "--obstacle-theta")
+            obstacleTheta = floatValue();
+        else if (arg == "--state")
+            statePath = value();
+        else if (arg == "--timing")
+            timingPath = value();
+        else if (arg == "--record")
+            recordPath = value();
+        else if (arg == "--trace")
+            tracePath = value();
+        else if (arg == "--graph")
+            graphPath = value();
+        else if (arg == "--load-checkpoint")
+            loadCheckpointPath = value();
+        else if (arg == "--save-checkpoint")
+            saveCheckpointPath = value();
+        else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!loadCheckpointPath.empty() && stepOptions) {
+        // The run would not continue as it was saved
+        std::fprintf(stderr, "--pairs, --order, --order-interval, --lod and --lod-radius come from the checkpoint\n");
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Load or generate scene
+    Scene scene;
+    if (!scenePath.empty()) {
+        if (!loadScene(scenePath, scene)) {
+            std::fprintf(stderr, "Could not load scene from %s\n", scenePath.c_str());
+            return 1;
+        }
+    } else if (loadCheckpointPath.empty()) {
+        scene = generateScene(width, height, numObstacles, seed);
+        scene.numBoids = 1000;
+    }
+    if (dt > 0.0f)
+        scene.dt = dt;
+
+    // Initialize simulation
+    Simulation sim;
+    if (!loadCheckpointPath.empty()) {
+        // Continue from checkpoint (settings, walls and obstacles from the checkpoint)
+        auto begin = std::chrono::steady_clock::now();
+        if (!loadCheckpoint(loadCheckpointPath, sim)) {
+            std::fprintf(stderr, "Could not load checkpoint from %s\n", loadCheckpointPath.c_str());
+            return 1;
+        }
+        std::printf("Checkpoint loaded in %.2f ms (step %llu)\n",
+                    std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count(),
+                    (unsigned long long)sim.getStep());
+        scene.settings = sim.getSettings();
+        scene.sources = sim.getForceField().getSources();
+        scene.numBoids = sim.getState().size();
+    }
+
+    // Overrides
+    if (numThreads > 0)
+        scene.settings.numThreads = numThreads;
+    if (viewRadius >= 0.0f)
+        scene.settings.viewRadius = viewRadius;
+    if (noise >= 0.0f)
+        scene.settings.noise = noise;
+    if (maxNeighbors >= 0)
+        scene.settings.maxNeighbors = maxNeighbors;
+    sim.setSettings(scene.settings);
+    if (loadCheckpointPath.empty()) {
+        sim.setPairMode(pairMode);
+        sim.setOrder(order, std::max(orderInterval, 1l));
+        sim.setLod(lod);
+    }
+    ObstacleCulling culling = sim.getObstacleCulling();
+    if (obstacleCutoff >= 0.0f)
+        culling.cutoff = obstacleCutoff;
+    if (obstacleTheta >= 0.0f)
+        culling.theta = obstacleTheta;
+    sim.setObstacleCulling(culling);
+
+    if (loadCheckpointPath.empty()) {
+        if (numBoids >= 0)
+            scene.numBoids = numBoids;
+        sim.setSeed(seed);
+        sim.setForceFieldSources(scene.sources);
+        sim.initBoids(scene.numBoids);
+    }
+    std::printf("Running %u boids, %ld steps, dt %g, %u thread(s), %zu obstacle(s)\n", scene.numBoids, numSteps, scene.dt,
+                sim.getPool().getNumThreads(), scene.sources.obstacles.size() + scene.sources.boxes.size());
+
+    // Trajectory recorder
+    TrajectoryWriter recorder;
+    if (!recordPath.empty() && !recorder.open(recordPath)) {
+        std::fprintf(stderr, "Could not open %s\n", recordPath.c_str());
+        return 1;
+    }
+
+    // Task graph (same result as sim.step followed by the record). The previous step is recorded from its snapshot on the side thread
+    // while this step runs, and the last step is recorded after the loop
+    TaskGraph graph;
+    auto recordSnapshot = [&] {
+        const BoidSnapshot& snapshot = sim.getSnapshots().acquire();
+        if (snapshot.size() > 0)
+            recorder.record(snapshot.state, snapshot.step);
+    };
+    if (!graphPath.empty()) {
+        graph.add("record", {"snapshot"}, {}, [&](ThreadPool&) { recordSnapshot(); }, TaskThread::SIDE);
+        sim.addStepTasks(graph, scene.dt);
+        graph.add("publish", {"positions", "velocities", "accelerations", "ids", "neighbors", "step"}, {"snapshot"},
+                  [&](ThreadPool&) { sim.publishSnapshot(); });
+    }
+
+    // Profiler (one frame per step)
+#ifdef BOIDS_ENABLE_PROFILER
+    if (!tracePath.empty())
+        Profiler::get().setMaxFrames(numSteps);
+#else
+    if (!tracePath.empty())
+        std::fprintf(stderr, "Profiler disabled, %s will not be written\n", tracePath.c_str());
+#endif
+
+    // Run steps
+    FILE* timing = std::fopen(timingPath.c_str(), "w");
+    if (!timing) {
+        std::fprintf(stderr, "Could not open %s\n", timingPath.c_str());
+        return 1;
+    }
+    std::fprintf(timing, "step,reorder_ms,neighbors_ms,steering_ms,integration_ms,total_ms,neighbors\n");
+    double totalTime = 0.0;
+    for (long s = 0; s < numSteps; s++) {
+        auto begin = std::chrono::steady_clock::now();
+        if (graph.size() > 0)
+            graph.run(sim.getPool());
+        else {
+            sim.step(scene.dt);
+            recorder.record(sim.getState(), sim.getStep(), sim.getSlots().data());
+        }
+        float total = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        totalTime += total;
+
+        const StepTiming& t = sim.getTiming();
+        std::fprintf(timing, "%ld,%.4f,%.4f,%.4f,%.4f,%.4f,%u\n", s, t.reorder, t.neighbors, t.steering, t.integration, total,
+                     sim.getNeighbors().getTotal());
+        PROFILE_FRAME();
+    }
+    std::fclose(timing);
+    if (graph.size() > 0 && recorder.isOpen())
+        recordSnapshot();
+    std::printf("Total %.2f ms, %.4f ms/step\n", totalTime, numSteps ? totalTime / numSteps : 0.0);
+    if (recorder.isOpen()) {
+        if (!recorder.close()) {
+            std::fprintf(stderr, "Could not write %s\n", recordPath.c_str());
+            return 1;
+        }
+        std::printf("Recorded %llu steps (%llu dropped), %.2f MB\n", (unsigned long long)recorder.getNumRecorded(),
+                    (unsigned long long)recorder.getNumDropped(), recorder.getBytesWritten() / 1e6);
+    }
+    if (!graphPath.empty() && !graph.saveDot(graphPath)) {
+        std::fprintf(stderr, "Could not write %s\n", graphPath.c_str());
+        return 1;
+    }
+#ifdef BOIDS_ENABLE_PROFILER
+    if (!tracePath.empty() && !Profiler::get().exportTrace(tracePath)) {
+        std::fprintf(stderr, "Could not write %s\n", tracePath.c_str());
+        return 1;
+    }
+#endif
+
+    if (!saveCheckpointPath.empty() && !saveCheckpoint(saveCheckpointPath, sim)) {
+        std::fprintf(stderr, "Could not save checkpoint to %s\n", saveCheckpointPath.c_str());
+        return 1;
+    }
+
+    // Final state (in id order)
+    FILE* state = std::fopen(statePath.c_str(), "w");
+    if (!state) {
+        std::fprintf(stderr, "Could not open %s\n", statePath.c_str());
+        return 1;
+    }
+    const BoidState& b = sim.getState();
+    std::fprintf(state, "id,x,y,vx,vy,ax,ay\n");
+    for (uint32_t id = 0; id < b.size(); id++) {
+        const uint32_t i = sim.getSlot(id);
+        std::fprintf(state, "%u,%.7g,%.7g,%.7g,%.7g,%.7g,%.7g\n", id, b.x[i], b.y[i], b.vx[i], b.vy[i], b.ax[i], b.ay[i]);
+    }
+    std::fclose(state);
+
+    return 0;
+}
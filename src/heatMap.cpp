@@ -0,0 +1,83 @@
+//--------------------------------------------------
+// Boids Basic
+// heatMap.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "heatMap.h"
+#include "forceFieldGrid.h"
+#include "profiler.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <cmath>
+
+void getHeatMapColor(float value, float* red, float* green, float* blue) {
+    // Thanks to https://www.andrewnoske.com/wiki/Code_-_heatmaps_and_color_gradients
+    const int NUM_COLORS = 4;
+    static float color[NUM_COLORS][3] = {{0, 0, 1}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}};
+    int idx1;
+    int idx2;
+    float fractBetween = 0;
+    if (value <= 0)
+        idx1 = idx2 = 0;
+    else if (value >= 1)
+        idx1 = idx2 = NUM_COLORS - 1;
+    else {
+        value = value * (NUM_COLORS - 1);
+        idx1 = std::floor(value);
+        idx2 = idx1 + 1;
+        fractBetween = value - float(idx1);
+    }
+    *red = (color[idx2][0] - color[idx1][0]) * fractBetween + color[idx1][0];
+    *green = (color[idx2][1] - color[idx1][1]) * fractBetween + color[idx1][1];
+    *blue = (color[idx2][2] - color[idx1][2]) * fractBetween + color[idx1][2];
+}
+
+uint32_t drawForceField(const ForceFieldGrid& forceField, uint8_t* data, ThreadPool& pool, bool all) {
+    const uint32_t width = forceField.getWidth();
+    const uint32_t height = forceField.getHeight();
+    const uint32_t tilesX = forceField.getNumTilesX();
+    const uint32_t numTiles = tilesX * forceField.getNumTilesY();
+    const uint32_t tileSize = ForceFieldGrid::tileSize;
+
+    pool.parallelFor(
+        numTiles,
+        [&](uint32_t tb, uint32_t te, unsigned) {
+            for (uint32_t t = tb; t < te; t++) {
+                if (!all && !forceField.isTileDirty(t))
+                    continue;
+                uint32_t ti = t % tilesX * tileSize;
+                uint32_t tj = t / tilesX * tileSize;
+                for (uint32_t i = ti; i < std::min(ti + tileSize, width); i++)
+                    for (uint32_t j = tj; j < std::min(tj + tileSize, height); j++) {
+                        float fx, fy;
+                        forceField.getCellForce(i, j, fx, fy);
+
+                        float value = std::log(std::log(std::sqrt(fx * fx + fy * fy) + 1) * 2 + 1);
+                        if (value > 1)
+                            value = 1;
+                        float r, g, b;
+                        getHeatMapColor(value, &r, &g, &b);
+
+                        unsigned index = (i + (height - 1 - j) * width) * 4;
+                        data[index + 0] = 255 * r;
+                        data[index + 1] = 255 * g;
+                        data[index + 2] = 255 * b;
+                        data[index + 3] = 255;
+                    }
+            }
+        },
+        1);
+
+#ifdef BOIDS_ENABLE_PROFILER
+    uint32_t numPixels = 0;
+    for (uint32_t t = 0; t < numTiles; t++)
+        if (all || forceField.isTileDirty(t)) {
+            uint32_t ti = t % tilesX * tileSize;
+            uint32_t tj = t / tilesX * tileSize;
+            numPixels += (std::min(ti + tileSize, width) - ti) * (std::min(tj + tileSize, height) - tj);
+        }
+    PROFILE_COUNTER_ADD("heatmap pixels", numPixels);
+#endif
+    return all ? numTiles : forceField.getNumDirtyTiles();
+}
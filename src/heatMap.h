@@ -0,0 +1,23 @@
+//--------------------------------------------------
+// Boids Basic
+// heatMap.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef HEAT_MAP_H
+#define HEAT_MAP_H
+#include <cstdint>
+
+class ForceFieldGrid;
+class ThreadPool;
+
+/// Heat map color of a value between 0 and 1 (blue, green, yellow, red)
+void getHeatMapColor(float value, float* red, float* green, float* blue);
+
+/// Draw force field heat map
+/** Writes one RGBA8 pixel per force field cell to data (width*height*4 bytes, first row is the top of the grid). Only the dirty tiles are
+ * drawn, or all tiles if all is true. Returns the number of tiles drawn
+ **/
+uint32_t drawForceField(const ForceFieldGrid& forceField, uint8_t* data, ThreadPool& pool, bool all = false);
+
+#endif // HEAT_MAP_H
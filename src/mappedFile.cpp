@@ -0,0 +1,66 @@
+//--------------------------------------------------
+// Boids Basic
+// mappedFile.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "mappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BOIDS_HAS_MMAP
+#endif
+
+MappedFile::MappedFile() : _data(nullptr), _size(0), _mapped(false) {}
+
+MappedFile::~MappedFile() { close(); }
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+#ifdef BOIDS_HAS_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            _data = static_cast<const uint8_t*>(data);
+            _size = st.st_size;
+            _mapped = true;
+        }
+    }
+    ::close(fd);
+    if (_mapped)
+        return true;
+#endif
+
+    // Read whole file
+    std::ifstream fs(filename, std::ios::binary);
+    if (!fs)
+        return false;
+    _buffer.assign(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+    if (_buffer.empty())
+        return false;
+    _data = _buffer.data();
+    _size = _buffer.size();
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef BOIDS_HAS_MMAP
+    if (_mapped)
+        munmap(const_cast<uint8_t*>(_data), _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+    _mapped = false;
+    _buffer.clear();
+    _buffer.shrink_to_fit();
+}
@@ -0,0 +1,38 @@
+//--------------------------------------------------
+// Boids Basic
+// mappedFile.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Read-only memory mapped file
+/** The file is mapped with mmap, so only the pages that are accessed are read from disk. When mmap is not available, the whole file is
+ * read to memory
+ **/
+class MappedFile {
+  public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+
+    bool isOpen() const { return _data != nullptr; }
+    const uint8_t* getData() const { return _data; }
+    size_t getSize() const { return _size; }
+
+  private:
+    const uint8_t* _data;
+    size_t _size;
+    bool _mapped;
+    std::vector<uint8_t> _buffer; ///< File data when it could not be mapped
+};
+
+#endif // MAPPED_FILE_H
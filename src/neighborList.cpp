@@ -0,0 +1,99 @@
+//--------------------------------------------------
+// Boids Basic
+// neighborList.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "neighborList.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static bool byIndex(const GridNeighbor& a, const GridNeighbor& b) { return a.index < b.index; }
+
+static bool byDistance(const GridNeighbor& a, const GridNeighbor& b) { return a.d2 < b.d2 || (a.d2 == b.d2 && a.index < b.index); }
+
+void NeighborList::build(const SpatialGrid& grid, const float* x, const float* y, uint32_t n, float radius, uint32_t maxNeighbors,
+                         ThreadPool& pool, bool pairs, const NeighborLod& lod) {
+    _pairs = pairs;
+    if (lod.grid)
+        _lod.resize(n);
+    else
+        _lod.clear();
+    _offsets.resize(n + 1);
+    _stagingWorker.resize(n);
+    _stagingOffset.resize(n);
+    _staging.resize(pool.getNumThreads());
+    for (Staging& staging : _staging) {
+        staging.indices.clear();
+        staging.dirX.clear();
+        staging.dirY.clear();
+        staging.dist.clear();
+        staging.numLod = 0;
+    }
+
+    // Query neighbors, each thread writes to its own staging buffer
+    pool.parallelFor(n, [&](uint32_t begin, uint32_t end, unsigned worker) {
+        Staging& staging = _staging[worker];
+        for (uint32_t i = begin; i < end; i++) {
+            std::vector<GridNeighbor>& candidates = staging.candidates;
+            candidates.clear();
+            if (pairs)
+                grid.queryForward(x, y, i, radius, candidates);
+            else if (lod.grid && grid.countAround(i) > lod.threshold) {
+                // Dense boid, only close neighbors
+                lod.grid->query(x, y, i, lod.radius, candidates);
+                staging.numLod++;
+                _lod[i] = 1;
+            } else {
+                grid.query(x, y, i, radius, candidates);
+                if (lod.grid)
+                    _lod[i] = 0;
+            }
+
+            // Keep only nearest neighbors (ties by index, so the result does not depend on the order of the candidates)
+            if (!pairs && maxNeighbors && candidates.size() > maxNeighbors) {
+                std::nth_element(candidates.begin(), candidates.begin() + maxNeighbors, candidates.end(), byDistance);
+                candidates.resize(maxNeighbors);
+                std::sort(candidates.begin(), candidates.end(), byIndex);
+            }
+
+            _stagingWorker[i] = worker;
+            _stagingOffset[i] = staging.indices.size();
+            _offsets[i + 1] = candidates.size();
+            for (const GridNeighbor& c : candidates) {
+                float d = std::sqrt(c.d2);
+                staging.indices.push_back(c.index);
+                staging.dirX.push_back(d > 0.0f ? c.dx / d : 0.0f);
+                staging.dirY.push_back(d > 0.0f ? c.dy / d : 0.0f);
+                staging.dist.push_back(d);
+            }
+        }
+    });
+
+    _numLod = 0;
+    for (const Staging& staging : _staging)
+        _numLod += staging.numLod;
+
+    // Offsets
+    _offsets[0] = 0;
+    for (uint32_t i = 0; i < n; i++)
+        _offsets[i + 1] += _offsets[i];
+
+    // Copy to final position
+    _indices.resize(_offsets[n]);
+    _dirX.resize(_offsets[n]);
+    _dirY.resize(_offsets[n]);
+    _dist.resize(_offsets[n]);
+    pool.parallelFor(n, [&](uint32_t begin, uint32_t end, unsigned) {
+        for (uint32_t i = begin; i < end; i++) {
+            const Staging& staging = _staging[_stagingWorker[i]];
+            const uint32_t from = _stagingOffset[i], to = _offsets[i], count = getNumNeighbors(i);
+            std::memcpy(_indices.data() + to, staging.indices.data() + from, count * sizeof(uint32_t));
+            std::memcpy(_dirX.data() + to, staging.dirX.data() + from, count * sizeof(float));
+            std::memcpy(_dirY.data() + to, staging.dirY.data() + from, count * sizeof(float));
+            std::memcpy(_dist.data() + to, staging.dist.data() + from, count * sizeof(float));
+        }
+    });
+}
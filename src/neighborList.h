@@ -0,0 +1,77 @@
+//--------------------------------------------------
+// Boids Basic
+// neighborList.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef NEIGHBOR_LIST_H
+#define NEIGHBOR_LIST_H
+#include "spatialGrid.h"
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/// Level of detail of the neighbor search
+/** Boids with more than threshold boids in the 3x3 cells around them are dense. Dense boids only get their close neighbors (within
+ * radius), found in grid, which must be built with a cell size of at least radius. The far neighbors are replaced by the cell statistics
+ * of the main grid (see SpatialGrid::sumAround) **/
+struct NeighborLod {
+    const SpatialGrid* grid = nullptr; ///< Disabled if null
+    float radius = 0.0f;
+    uint32_t threshold = 0;
+};
+
+/// Neighbors of all boids in compressed sparse row format
+/** The neighbors of boid i are indices[offsets[i]] to indices[offsets[i+1]-1], sorted by boid index. The unit vector from the boid to
+ * each neighbor and their distance are stored in arrays with the same layout, from the values computed by the grid query, so the
+ * steering rules read them sequentially instead of gathering the neighbor positions. All memory is reused from one step to the next, so
+ * no allocations are done after the first steps.
+ *
+ * When built with pairs, each pair of boids is stored only once, in the list of one of the two boids (see SpatialGrid::queryForward)
+ **/
+class NeighborList {
+  public:
+    /// Build list from the grid
+    /** When maxNeighbors is not zero, only the maxNeighbors nearest neighbors of each boid are kept (ignored when building pairs) **/
+    void build(const SpatialGrid& grid, const float* x, const float* y, uint32_t n, float radius, uint32_t maxNeighbors, ThreadPool& pool,
+               bool pairs = false, const NeighborLod& lod = {});
+    /// Each pair is stored once
+    bool hasPairs() const { return _pairs; }
+    /// Boid i is dense and only has its close neighbors (see NeighborLod)
+    bool isLod(uint32_t i) const { return !_lod.empty() && _lod[i]; }
+    uint32_t getNumLod() const { return _numLod; }
+
+    const uint32_t* getNeighbors(uint32_t i) const { return _indices.data() + _offsets[i]; }
+    uint32_t getNumNeighbors(uint32_t i) const { return _offsets[i + 1] - _offsets[i]; }
+    /// Unit vectors from boid i to its neighbors (zero if they are at the same position)
+    const float* getDirX(uint32_t i) const { return _dirX.data() + _offsets[i]; }
+    const float* getDirY(uint32_t i) const { return _dirY.data() + _offsets[i]; }
+    /// Distances from boid i to its neighbors
+    const float* getDistances(uint32_t i) const { return _dist.data() + _offsets[i]; }
+    uint32_t getOffset(uint32_t i) const { return _offsets[i]; }
+    uint32_t getNumBoids() const { return _offsets.empty() ? 0 : _offsets.size() - 1; }
+    uint32_t getTotal() const { return _indices.size(); }
+
+  private:
+    /// Neighbors found by one thread before being copied to the final position
+    struct Staging {
+        std::vector<uint32_t> indices;
+        std::vector<float> dirX, dirY, dist;
+        std::vector<GridNeighbor> candidates;
+        uint32_t numLod;
+    };
+
+    bool _pairs = false;
+    std::vector<uint8_t> _lod; ///< Empty if the level of detail is disabled
+    uint32_t _numLod = 0;
+    std::vector<uint32_t> _offsets;
+    std::vector<uint32_t> _indices;
+    std::vector<float> _dirX, _dirY, _dist;
+
+    std::vector<Staging> _staging; ///< One per thread
+    std::vector<uint32_t> _stagingWorker;
+    std::vector<uint32_t> _stagingOffset;
+};
+
+#endif // NEIGHBOR_LIST_H
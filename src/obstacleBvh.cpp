@@ -0,0 +1,157 @@
+//--------------------------------------------------
+// Boids Basic
+// obstacleBvh.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "obstacleBvh.h"
+#include "profiler.h"
+#include <algorithm>
+#include <limits>
+
+// Squared distance between two boxes (zero if they overlap)
+static float boxDistance2(float aMinX, float aMinY, float aMaxX, float aMaxY, float bMinX, float bMinY, float bMaxX, float bMaxY) {
+    float dx = std::max({aMinX - bMaxX, bMinX - aMaxX, 0.0f});
+    float dy = std::max({aMinY - bMaxY, bMinY - aMaxY, 0.0f});
+    return dx * dx + dy * dy;
+}
+
+void ObstacleBvh::build(const ForceFieldSources& sources) {
+    PROFILE_SCOPE("obstacle bvh build");
+    _obstacles.assign(sources.obstacles, sources.boxes);
+    const uint32_t n = _obstacles.size();
+    _items.resize(n);
+    for (uint32_t k = 0; k < n; k++)
+        _items[k] = k;
+    _nodes.clear();
+    if (n == 0)
+        return;
+    _nodes.reserve(2 * ((n + leafSize - 1) / leafSize));
+    _nodes.emplace_back();
+    buildNode(0, 0, n);
+}
+
+void ObstacleBvh::buildNode(uint32_t node, uint32_t begin, uint32_t end) {
+    if (end - begin <= leafSize) {
+        _nodes[node].first = begin;
+        _nodes[node].count = end - begin;
+        refitNode(_nodes[node]);
+        return;
+    }
+
+    // Split at the median center along the longer axis of the centers
+    float minX = std::numeric_limits<float>::infinity(), minY = minX;
+    float maxX = -minX, maxY = -minX;
+    for (uint32_t i = begin; i < end; i++) {
+        minX = std::min(minX, _obstacles.x[_items[i]]);
+        maxX = std::max(maxX, _obstacles.x[_items[i]]);
+        minY = std::min(minY, _obstacles.y[_items[i]]);
+        maxY = std::max(maxY, _obstacles.y[_items[i]]);
+    }
+    const std::vector<float>& axis = maxX - minX >= maxY - minY ? _obstacles.x : _obstacles.y;
+    const uint32_t mid = begin + (end - begin) / 2;
+    std::nth_element(_items.begin() + begin, _items.begin() + mid, _items.begin() + end,
+                     [&](uint32_t a, uint32_t b) { return axis[a] < axis[b] || (axis[a] == axis[b] && a < b); });
+
+    const uint32_t left = _nodes.size();
+    _nodes.resize(left + 2);
+    _nodes[node].first = left;
+    _nodes[node].count = 0;
+    buildNode(left, begin, mid);
+    buildNode(left + 1, mid, end);
+    refitNode(_nodes[node]);
+}
+
+void ObstacleBvh::refit(const ForceFieldSources& sources) {
+    PROFILE_SCOPE("obstacle bvh refit");
+    _obstacles.assign(sources.obstacles, sources.boxes);
+    // Children are always after their parent
+    for (uint32_t i = _nodes.size(); i-- > 0;)
+        refitNode(_nodes[i]);
+}
+
+void ObstacleBvh::refitNode(Node& node) const {
+    node.minX = node.minY = std::numeric_limits<float>::infinity();
+    node.maxX = node.maxY = -std::numeric_limits<float>::infinity();
+    float sumX = 0.0f, sumY = 0.0f;
+    node.strength = 0.0f;
+    auto add = [&](float minX, float minY, float maxX, float maxY, float cx, float cy, float strength) {
+        node.minX = std::min(node.minX, minX);
+        node.minY = std::min(node.minY, minY);
+        node.maxX = std::max(node.maxX, maxX);
+        node.maxY = std::max(node.maxY, maxY);
+        sumX += cx * strength;
+        sumY += cy * strength;
+        node.strength += strength;
+    };
+    if (node.count > 0) {
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            const uint32_t k = _items[i];
+            float minX, minY, maxX, maxY;
+            _obstacles.getBounds(k, minX, minY, maxX, maxY);
+            add(minX, minY, maxX, maxY, _obstacles.x[k], _obstacles.y[k], _obstacles.radius[k]);
+        }
+    } else {
+        for (const Node& child : {_nodes[node.first], _nodes[node.first + 1]})
+            add(child.minX, child.minY, child.maxX, child.maxY, child.cx, child.cy, child.strength);
+    }
+
+    // Center of the bounds if there is no strength
+    if (node.strength > 0.0f) {
+        node.cx = sumX / node.strength;
+        node.cy = sumY / node.strength;
+    } else {
+        node.cx = (node.minX + node.maxX) * 0.5f;
+        node.cy = (node.minY + node.maxY) * 0.5f;
+    }
+}
+
+template <typename Visit>
+void ObstacleBvh::traverse(const ObstacleCulling& culling, float minX, float minY, float maxX, float maxY, Visit&& visit) const {
+    if (_nodes.empty())
+        return;
+    const float cutoff2 = culling.cutoff > 0.0f ? culling.cutoff * culling.cutoff : std::numeric_limits<float>::infinity();
+    const float theta2 = culling.theta * culling.theta;
+
+    // Left child is visited first, so the order of the obstacles does not depend on the region
+    uint32_t stack[64];
+    uint32_t size = 0;
+    stack[size++] = 0;
+    while (size > 0) {
+        const Node& node = _nodes[stack[--size]];
+        const float d2 = boxDistance2(minX, minY, maxX, maxY, node.minX, node.minY, node.maxX, node.maxY);
+        if (d2 > cutoff2)
+            continue;
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; i++)
+                visit(_items[i], nullptr);
+            continue;
+        }
+        const float extent = std::max(node.maxX - node.minX, node.maxY - node.minY);
+        if (extent * extent < theta2 * d2) {
+            visit(0, &node);
+            continue;
+        }
+        stack[size++] = node.first + 1;
+        stack[size++] = node.first;
+    }
+}
+
+void ObstacleBvh::addForce(const ObstacleCulling& culling, float x, float y, float& fx, float& fy) const {
+    const float limit2 = culling.cutoff > 0.0f ? culling.cutoff * culling.cutoff : std::numeric_limits<float>::infinity();
+    traverse(culling, x, y, x, y, [&](uint32_t k, const Node* group) {
+        if (group)
+            getObstacleForce({group->cx, group->cy, group->strength}, x, y, fx, fy);
+        else
+            addObstacleForce(_obstacles, k, x, y, limit2, fx, fy);
+    });
+}
+
+void ObstacleBvh::gather(const ObstacleCulling& culling, float minX, float minY, float maxX, float maxY, ObstacleArrays& out) const {
+    traverse(culling, minX, minY, maxX, maxY, [&](uint32_t k, const Node* group) {
+        if (group)
+            out.addDisk({group->cx, group->cy, group->strength});
+        else
+            out.add(_obstacles, k, culling.cutoff);
+    });
+}
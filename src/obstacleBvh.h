@@ -0,0 +1,71 @@
+//--------------------------------------------------
+// Boids Basic
+// obstacleBvh.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef OBSTACLE_BVH_H
+#define OBSTACLE_BVH_H
+#include "forceField.h"
+
+/// Broad phase settings of the obstacle forces (see ObstacleBvh)
+struct ObstacleCulling {
+    float cutoff = 0.0f; ///< Obstacles farther than this from a point are ignored (0 for no cutoff)
+    float theta = 0.0f;  ///< Groups of obstacles smaller than theta times their distance are replaced by one disk (0 for no grouping)
+
+    bool isEnabled() const { return cutoff > 0.0f || theta > 0.0f; }
+    bool operator==(const ObstacleCulling& o) const { return cutoff == o.cutoff && theta == o.theta; }
+    bool operator!=(const ObstacleCulling& o) const { return !(*this == o); }
+};
+
+/// Bounding volume hierarchy over the disks and boxes
+/** Binary tree of the obstacle cores (disk centers and box core segments), with at most leafSize obstacles in each leaf. Each node also
+ * keeps the sum of the strengths (radius) of its obstacles and their strength weighted center, so a distant node can be replaced by a
+ * single disk, as in Barnes-Hut. The distance used by the cutoff and by the grouping is the distance between the query region and the
+ * node bounds, so queries for a region return the same obstacles for all points of the region.
+ *
+ * When the obstacles move but are not added/removed, refit updates the node bounds and groups keeping the tree, which is much cheaper
+ * than a build but gets looser as the obstacles move away from their initial positions.
+ **/
+class ObstacleBvh {
+  public:
+    static constexpr uint32_t leafSize = 4;
+
+    /// Build tree over the disks and boxes of the sources
+    void build(const ForceFieldSources& sources);
+
+    /// Update bounds and groups after the obstacles moved (same number of disks and boxes as the last build)
+    void refit(const ForceFieldSources& sources);
+
+    /// Add the force generated by the obstacles at (x, y) to (fx, fy)
+    void addForce(const ObstacleCulling& culling, float x, float y, float& fx, float& fy) const;
+
+    /// Obstacles and groups that contribute to the points inside the region, appended to out
+    /** Obstacles are appended with the cutoff (see ObstacleArrays::limit2), so evaluating them with addObstaclesForceBatch gives the
+     * same result as addForce at any point of the region, apart from the rounding of the grouped nodes **/
+    void gather(const ObstacleCulling& culling, float minX, float minY, float maxX, float maxY, ObstacleArrays& out) const;
+
+    uint32_t getNumNodes() const { return _nodes.size(); }
+    uint32_t getNumObstacles() const { return _obstacles.size(); }
+
+  private:
+    struct Node {
+        float minX, minY, maxX, maxY; ///< Bounds of the obstacle cores
+        float cx, cy;                 ///< Strength weighted center
+        float strength;               ///< Sum of the radius
+        uint32_t first;               ///< First item (leaf) or left child (the right child is first + 1)
+        uint32_t count;               ///< Number of items (zero for inner nodes)
+    };
+
+    void buildNode(uint32_t node, uint32_t begin, uint32_t end);
+    void refitNode(Node& node) const;
+
+    template <typename Visit>
+    void traverse(const ObstacleCulling& culling, float minX, float minY, float maxX, float maxY, Visit&& visit) const;
+
+    std::vector<Node> _nodes;
+    std::vector<uint32_t> _items; ///< Obstacle of each leaf slot
+    ObstacleArrays _obstacles;    ///< Disks followed by boxes, without cutoff
+};
+
+#endif // OBSTACLE_BVH_H
@@ -0,0 +1,104 @@
+//--------------------------------------------------
+// Boids Basic
+// profiler.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "profiler.h"
+#include <chrono>
+#include <cstdio>
+
+static uint64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler::Profiler() : _start(steadyNs()), _frameBegin(0), _maxFrames(300), _enabled(true) {}
+
+Profiler& Profiler::get() {
+    static Profiler profiler;
+    return profiler;
+}
+
+uint64_t Profiler::now() const { return steadyNs() - _start; }
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _threads.push_back(std::make_unique<ThreadBuffer>());
+        _threads.back()->id = _threads.size() - 1;
+        buffer = _threads.back().get();
+    }
+    return *buffer;
+}
+
+void Profiler::addEvent(const char* name, uint64_t begin, uint64_t end) {
+    if (!_enabled)
+        return;
+    // Bounded when frames are never ended (e.g. a Simulation used without the project or the headless runner)
+    ThreadBuffer& buffer = getThreadBuffer();
+    if (buffer.events.size() < maxThreadEvents)
+        buffer.events.push_back({name, begin, end - begin, buffer.id});
+}
+
+Profiler::Counter& Profiler::getCounter(const char* name) {
+    for (Counter& counter : _counters)
+        if (counter.name == name)
+            return counter;
+    _counters.push_back({name, 0.0});
+    return _counters.back();
+}
+
+void Profiler::setCounter(const char* name, double value) {
+    if (_enabled)
+        getCounter(name).value = value;
+}
+
+void Profiler::addCounter(const char* name, double value) {
+    if (_enabled)
+        getCounter(name).value += value;
+}
+
+void Profiler::endFrame() {
+    Frame frame;
+    frame.begin = _frameBegin;
+    frame.end = now();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (std::unique_ptr<ThreadBuffer>& thread : _threads) {
+            frame.events.insert(frame.events.end(), thread->events.begin(), thread->events.end());
+            thread->events.clear();
+        }
+    }
+    frame.counters = _counters;
+    for (Counter& counter : _counters)
+        counter.value = 0.0;
+
+    _frames.push_back(std::move(frame));
+    while (_frames.size() > _maxFrames)
+        _frames.pop_front();
+    _frameBegin = _frames.back().end;
+}
+
+bool Profiler::exportTrace(const std::string& filename) const {
+    FILE* file = std::fopen(filename.c_str(), "w");
+    if (!file)
+        return false;
+
+    // Timestamps in microseconds
+    std::fprintf(file, "{\"traceEvents\":[\n");
+    bool first = true;
+    for (const Frame& frame : _frames) {
+        std::fprintf(file, "%s{\"name\":\"frame\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f}", first ? "" : ",\n",
+                     frame.begin / 1e3, (frame.end - frame.begin) / 1e3);
+        first = false;
+        for (const Event& e : frame.events)
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", e.name, e.thread, e.begin / 1e3,
+                         e.duration / 1e3);
+        for (const Counter& c : frame.counters)
+            std::fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":0,\"ts\":%.3f,\"args\":{\"value\":%.6g}}", c.name, frame.end / 1e3,
+                         c.value);
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
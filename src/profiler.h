@@ -0,0 +1,113 @@
+//--------------------------------------------------
+// Boids Basic
+// profiler.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef PROFILER_H
+#define PROFILER_H
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// Frame profiler
+/** Scoped timers and counters grouped by frame. Timers can be used from any thread, each thread writes to its own buffer. Counters and
+ * endFrame must be used from the main thread while there is no parallel work running. The last frames are kept to be plotted and
+ * exported as Chrome trace events (chrome://tracing or https://ui.perfetto.dev).
+ *
+ * Use the PROFILE_* macros, they compile to nothing when BOIDS_ENABLE_PROFILER is not defined. Names must be string literals
+ **/
+class Profiler {
+  public:
+    struct Event {
+        const char* name;
+        uint64_t begin;    ///< Nanoseconds since the profiler was created
+        uint64_t duration; ///< Nanoseconds
+        uint32_t thread;   ///< 0 is the first thread that used the profiler
+    };
+    struct Counter {
+        const char* name;
+        double value;
+    };
+    struct Frame {
+        uint64_t begin;
+        uint64_t end;
+        std::vector<Event> events;
+        std::vector<Counter> counters;
+    };
+
+    static Profiler& get();
+
+    uint64_t now() const;
+    /// Thread id of the calling thread (same as Event::thread)
+    uint32_t getThread() { return getThreadBuffer().id; }
+    void addEvent(const char* name, uint64_t begin, uint64_t end);
+    void setCounter(const char* name, double value);
+    void addCounter(const char* name, double value);
+    /// Move events and counters of this frame to the frame history
+    void endFrame();
+    /// Stop recording events and counters (for example when many simulations run at the same time, see sweep.h)
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    /// Last frames, oldest first
+    const std::deque<Frame>& getFrames() const { return _frames; }
+    void setMaxFrames(uint32_t maxFrames) { _maxFrames = maxFrames; }
+
+    /// Export last frames as Chrome trace event JSON
+    bool exportTrace(const std::string& filename) const;
+
+  private:
+    static constexpr uint32_t maxThreadEvents = 1 << 16; ///< Events kept per thread until endFrame (more are dropped)
+
+    struct ThreadBuffer {
+        uint32_t id;
+        std::vector<Event> events;
+    };
+
+    Profiler();
+    ThreadBuffer& getThreadBuffer();
+    Counter& getCounter(const char* name);
+
+    const uint64_t _start;
+    std::mutex _mutex; ///< Thread buffer creation
+    std::vector<std::unique_ptr<ThreadBuffer>> _threads;
+    std::vector<Counter> _counters;
+    uint64_t _frameBegin;
+    std::deque<Frame> _frames;
+    uint32_t _maxFrames;
+    std::atomic<bool> _enabled;
+};
+
+/// Records the time between construction and destruction
+class ProfileScope {
+  public:
+    explicit ProfileScope(const char* name) : _name(name), _begin(Profiler::get().now()) {}
+    ~ProfileScope() { Profiler::get().addEvent(_name, _begin, Profiler::get().now()); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+  private:
+    const char* _name;
+    uint64_t _begin;
+};
+
+#ifdef BOIDS_ENABLE_PROFILER
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_COUNTER(name, value) Profiler::get().setCounter(name, value)
+#define PROFILE_COUNTER_ADD(name, value) Profiler::get().addCounter(name, value)
+#define PROFILE_FRAME() Profiler::get().endFrame()
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_COUNTER(name, value)
+#define PROFILE_COUNTER_ADD(name, value)
+#define PROFILE_FRAME()
+#endif
+
+#endif // PROFILER_H
@@ -6,25 +6,34 @@
 //--------------------------------------------------
 #include "projectScript.h"
 #include "boidComponent.h"
+#include "checkpoint.h"
 #include "settingsComponent.h"
 #include "common.h"
-#include "forceField.h"
+#include "heatMap.h"
 #include <atta/component/components/material.h>
+#include <atta/component/components/mesh.h>
 #include <atta/component/components/prototype.h>
 #include <atta/component/components/relationship.h>
 #include <atta/component/components/transform.h>
 #include <atta/component/interface.h>
-#include <atta/graphics/drawer.h>
 #include <atta/graphics/interface.h>
 #include <atta/resource/interface.h>
+#include <algorithm>
+#include <cmath>
 
 namespace scr = atta::script;
 namespace rsc = atta::resource;
 namespace gfx = atta::graphics;
 
-Project::Project() : _running(false), _bgImage(nullptr) {}
+Project::Project()
+    : _running(false), _showViewRadius(false), _bgImage(nullptr), _bgPending(false), _bgForceFieldTime(0.0f), _bgImageTime(0.0f), _bgTilesUpdated(0),
+      _bgTilesDrawn(0), _seed(42), _frameDt(0.0f), _graphPath("frame.dot"), _replaying(false), _replayPlaying(false), _replayStep(0),
+      _trajectoryPath("trajectory.boids"), _checkpointPath("checkpoint.boids"), _restored(false), _tracePath("trace.json"), _scriptsBegin(0) {}
 
 void Project::onLoad() {
+    // Boid state is allocated once for the maximum number of boids
+    _sim.reserve(getMaxBoids());
+
     if (!_bgImage) {
         // Create image
         rsc::Image::CreateInfo info{};
@@ -43,90 +52,322 @@ void Project::onLoad() {
 
 void Project::onStart() {
     _running = true;
-    srand(42); // Repeatable simulations
-    initBoids();
+    if (!_restored) {
+        _sim.setSeed(_seed); // Repeatable simulations
+        initBoids();
+    }
+    _restored = false;
+    _scheduler.reset();
+    _lastFrame = std::chrono::steady_clock::now();
 }
 
 void Project::initBoids() {
-    // Initialize boids randomly
-    for (cmp::Entity boid : cmp::getFactory(boidPrototype)->getClones()) {
-        cmp::Transform* t = boid.get<cmp::Transform>();
-        BoidComponent* b = boid.get<BoidComponent>();
-
-        // Calculate size and offset
-        atta::vec3& tp = topWall.get<cmp::Transform>()->position;
-        atta::vec3& bp = bottomWall.get<cmp::Transform>()->position;
-        atta::vec3& lp = leftWall.get<cmp::Transform>()->position;
-        atta::vec3& rp = rightWall.get<cmp::Transform>()->position;
-        atta::vec2 offset((rp.x + lp.x) / 2.0f, (tp.y + bp.y) / 2.0f);
-        atta::vec2 size(rp.x - lp.x, tp.y - bp.y);
-
-        // Initialize each boid position
-        t->position.x = ((rand() % 1000) / 1000.0f - 0.5f) * size.x + offset.x;
-        t->position.y = ((rand() % 1000) / 1000.0f - 0.5f) * size.y + offset.y;
+    // Walls are used to choose the initial positions
+    updateWalls();
+    updateObstacles();
 
-        float rAngle = (rand() % 1000) / 1000.0f;
-        b->velocity.x = cos(rAngle);
-        b->velocity.y = sin(rAngle);
-    }
+    // Initialize boids randomly
+    _boids = cmp::getFactory(boidPrototype)->getClones();
+    _sim.initBoids(_boids.size());
+    writeBoids();
+    trackBoids();
 }
 
 void Project::onStop() {
     _running = false;
-    gfx::Drawer::clear<gfx::Drawer::Line>("boidView");
+    stopRecording();
+    clearViewRadius();
 }
 
 void Project::onUpdateBefore(float) {
+    // A frame goes from one onUpdateBefore to the next one
+    PROFILE_FRAME();
+    PROFILE_SCOPE("onUpdateBefore");
+
+    SettingsComponent* s = settings.get<SettingsComponent>();
+    _sim.setSettings({s->viewRadius, s->collisionAvoidanceFactor, s->velocityMatchingFactor, s->flockCenteringFactor, s->noise,
+                      s->maxNeighbors, s->numThreads});
+    _boids = cmp::getFactory(boidPrototype)->getClones();
+
     updateWalls();
+    updateObstacles();
     updateBackground();
+    if (!_replaying) {
+        // Boids cloned or despawned while running, and components changed in the editor
+        syncBoids();
+    }
+#ifdef BOIDS_ENABLE_PROFILER
+    _scriptsBegin = Profiler::get().now();
+#endif
+}
+
+void Project::onUpdateAfter(float dt) {
+#ifdef BOIDS_ENABLE_PROFILER
+    Profiler::get().addEvent("boid scripts", _scriptsBegin, Profiler::get().now());
+#endif
+    PROFILE_SCOPE("onUpdateAfter");
+    if (_frameGraph.size() == 0)
+        createFrameGraph();
+    _frameDt = dt;
+    _frameGraph.run(_sim.getPool());
+}
+
+void Project::createFrameGraph() {
+    // All tasks run on the main thread: the engine owns the components, and the steps and the heat map tiles both use the whole thread
+    // pool (a side thread would draw the tiles with a single thread)
+    _frameGraph.add("steps", {"forceField"}, {"boids", "snapshot"}, [this](ThreadPool&) { runSteps(_frameDt); });
+    _frameGraph.add("background", {"forceField"}, {"backgroundImage"}, [this](ThreadPool& pool) { drawBackground(pool); });
+    // Components are read back in onUpdateBefore, so they are written from the state of this frame
+    _frameGraph.add("capture", {"boids"}, {"components"}, [this](ThreadPool&) {
+        if (!_replaying)
+            writeBoids();
+    });
+    _frameGraph.add("viewRadius", {"snapshot"}, {"viewDisks"}, [this](ThreadPool&) { updateViewRadius(); });
+    _frameGraph.add("upload", {"backgroundImage"}, {}, [this](ThreadPool&) { uploadBackground(); });
+}
+
+void Project::runSteps(float dt) {
+    if (_replaying) {
+        // Play recorded steps instead of simulating
+        if (_replayPlaying)
+            _replayStep = _replayStep < _replay.getLastStep() ? _replayStep + 1 : _replay.getFirstStep();
+        loadReplayStep();
+        _sim.publishSnapshot();
+        return;
+    }
+
+    // Fixed timestep (the engine dt is used until another one is chosen)
+    StepScheduler::Config& config = _scheduler.getConfig();
+    if (config.dt <= 0.0f)
+        config.dt = dt;
+
+    // Run steps of this frame
+    auto now = std::chrono::steady_clock::now();
+    _scheduler.beginFrame(std::chrono::duration<float>(now - _lastFrame).count());
+    _lastFrame = now;
+    while (_scheduler.nextStep()) {
+        _sim.step(config.dt);
+        _recorder.record(_sim.getState(), _sim.getStep(), _sim.getSlots().data());
+    }
+    PROFILE_COUNTER("steps", _scheduler.getStepsLastFrame());
+    _sim.publishSnapshot();
+}
+
+void Project::stopRecording() {
+    if (!_recorder.close())
+        LOG_WARN("Project", "Could not write trajectory [w]$0[]", _trajectoryPath);
+}
+
+bool Project::loadReplayStep() {
+    _boids = cmp::getFactory(boidPrototype)->getClones();
+    if (!_replay.readStep(_replayStep, _sim.getState()))
+        return false;
+    _sim.setIds(nullptr); // Recorded in id order
+
+    // The number of clones must match the recorded number of boids
+    if (_sim.getState().size() != _boids.size()) {
+        LOG_WARN("Project", "Recorded [w]$0[] boids, but there are [w]$1[] clones", _sim.getState().size(), _boids.size());
+        _replaying = false;
+        return false;
+    }
+    writeBoids();
+    trackBoids();
+    return true;
+}
+
+void Project::updateViewRadius() {
+    if (!_showViewRadius)
+        return;
+    PROFILE_SCOPE("updateViewRadius");
+
+    // One disk entity per boid (the engine draws its mesh like the disk obstacles), created or deleted when the number of boids changes
+    const BoidState& state = _sim.getSnapshots().acquire().state;
+    const uint32_t n = state.size();
+    while (_viewEntities.size() < n) {
+        cmp::Entity view = cmp::createEntity();
+        view.add<cmp::Transform>();
+        view.add<cmp::Mesh>()->sid = atta::StringId("meshes/disk.obj");
+        _viewEntities.push_back(view);
+    }
+    while (_viewEntities.size() > n) {
+        cmp::deleteEntity(_viewEntities.back());
+        _viewEntities.pop_back();
+    }
 
-    // Update neighbors
-    for (cmp::Entity boid : cmp::getFactory(boidPrototype)->getClones()) {
-        cmp::Transform* t = boid.get<cmp::Transform>();
-        BoidComponent* boidInfo = boid.get<BoidComponent>();
-        boidInfo->neighbors.clear();
-        boidInfo->acceleration = atta::vec2(0.0f);
-
-        // For each other boid -> O(n^2)
-        for (cmp::Entity other : cmp::getFactory(boidPrototype)->getClones()) {
-            if (boid == other)
-                continue;
-
-            // Test if other is a neighbor
-            cmp::Transform* ot = other.get<cmp::Transform>();
-            if ((atta::vec2(ot->position) - atta::vec2(t->position)).length() <= settings.get<SettingsComponent>()->viewRadius)
-                boidInfo->neighbors.push_back(other);
+    // Only the transform of each disk is written (the disk mesh has unit diameter, like the box mesh has unit size), below the boids and
+    // above the background
+    const float diameter = 2.0f * _sim.getSettings().viewRadius;
+    _sim.getPool().parallelFor(n, [&](uint32_t begin, uint32_t end, unsigned) {
+        for (uint32_t i = begin; i < end; i++) {
+            cmp::Transform* t = _viewEntities[i].get<cmp::Transform>();
+            t->position = atta::vec3(state.x[i], state.y[i], -0.5f);
+            t->scale = atta::vec3(diameter, diameter, 1.0f);
         }
+    });
+}
+
+void Project::clearViewRadius() {
+    for (cmp::Entity view : _viewEntities)
+        cmp::deleteEntity(view);
+    _viewEntities.clear();
+}
+
+void Project::syncBoids() {
+    bool changed = _boids.size() != _boidEntities.size() || _boids.size() != _sim.getState().size();
+    for (uint32_t i = 0; i < _boids.size() && !changed; i++)
+        changed = _boids[i].getId() != _boidEntities[i];
+    if (!changed) {
+        readBoids();
+        return;
+    }
+
+    // Clones that were not boids in the last frame
+    std::vector<cmp::EntityId> known = _boidEntities;
+    std::sort(known.begin(), known.end());
+    _spawned.clear();
+    for (uint32_t i = 0; i < _boids.size(); i++)
+        if (!std::binary_search(known.begin(), known.end(), _boids[i].getId()))
+            _spawned.push_back(i);
+
+    // All boids are read back in creation order, then the new ones are placed
+    _sim.getState().resize(_boids.size());
+    _sim.setIds(nullptr);
+    readBoids();
+    if (!_spawned.empty()) {
+        _sim.placeBoids(_spawned.data(), _spawned.size());
+        writeBoids();
     }
+    trackBoids();
 }
 
-void Project::onUpdateAfter(float dt) {
-    const float maxAcc = 3.0;
-    const float maxVel = 10;
+void Project::trackBoids() {
+    _boidEntities.resize(_boids.size());
+    for (uint32_t i = 0; i < _boids.size(); i++)
+        _boidEntities[i] = _boids[i].getId();
+}
+
+void Project::readBoids() {
+    PROFILE_SCOPE("readBoids");
+    BoidState& state = _sim.getState();
+    for (uint32_t i = 0; i < _boids.size(); i++) {
+        cmp::Transform* t = _boids[i].get<cmp::Transform>();
+        BoidComponent* b = _boids[i].get<BoidComponent>();
+        const uint32_t k = _sim.getSlot(i);
+        state.x[k] = t->position.x;
+        state.y[k] = t->position.y;
+        state.vx[k] = b->velocity.x;
+        state.vy[k] = b->velocity.y;
+        state.ax[k] = b->acceleration.x;
+        state.ay[k] = b->acceleration.y;
+    }
+}
 
-    // Update positions, velocities and accelerations
-    for (cmp::Entity boid : cmp::getFactory(boidPrototype)->getClones()) {
-        cmp::Transform* t = boid.get<cmp::Transform>();
-        BoidComponent* boidInfo = boid.get<BoidComponent>();
+void Project::writeBoids(uint32_t first) {
+    PROFILE_SCOPE("writeBoids");
+    const BoidState& state = _sim.getState();
+    const NeighborList& neighbors = _sim.getNeighbors();
+    const bool hasNeighbors = neighbors.getNumBoids() == _boids.size();
+    _sim.getPool().parallelFor(_boids.size() - first, [&](uint32_t begin, uint32_t end, unsigned) {
+        for (uint32_t i = first + begin; i < first + end; i++) {
+            // Entity i is the boid with id i
+            cmp::Transform* t = _boids[i].get<cmp::Transform>();
+            BoidComponent* b = _boids[i].get<BoidComponent>();
+            const uint32_t k = _sim.getSlot(i);
+            t->position.x = state.x[k];
+            t->position.y = state.y[k];
+            b->velocity = atta::vec2(state.vx[k], state.vy[k]);
+            b->acceleration = atta::vec2(state.ax[k], state.ay[k]);
+            if (b->velocity.length() > 0)
+                t->orientation.rotationFromVectors(atta::normalize(atta::vec3(b->velocity, 0.0f)), atta::vec3(0, -1, 0));
+            if (hasNeighbors) {
+                b->firstNeighbor = neighbors.getOffset(k);
+                b->numNeighbors = _sim.getNumNeighbors(k);
+            }
+        }
+    });
+}
 
-        // Limit vectors
-        if (boidInfo->acceleration.length() > maxAcc)
-            boidInfo->acceleration = atta::normalize(boidInfo->acceleration) * maxAcc;
-        if (boidInfo->velocity.length() > maxVel)
-            boidInfo->velocity = atta::normalize(boidInfo->velocity) * maxVel;
+bool Project::restoreCheckpoint() {
+    if (!loadCheckpoint(_checkpointPath, _sim)) {
+        LOG_WARN("Project", "Could not load checkpoint [w]$0[]", _checkpointPath);
+        return false;
+    }
 
-        // Update velocity
-        boidInfo->velocity += boidInfo->acceleration * dt;
-        boidInfo->velocity.normalize();
+    // Settings
+    SettingsComponent* s = settings.get<SettingsComponent>();
+    const SimulationSettings& ss = _sim.getSettings();
+    s->viewRadius = ss.viewRadius;
+    s->collisionAvoidanceFactor = ss.collisionAvoidanceFactor;
+    s->velocityMatchingFactor = ss.velocityMatchingFactor;
+    s->flockCenteringFactor = ss.flockCenteringFactor;
+    s->noise = ss.noise;
+    s->maxNeighbors = ss.maxNeighbors;
+    s->numThreads = ss.numThreads;
+
+    // Walls
+    const ForceFieldSources& sources = _sim.getForceField().getSources();
+    if (cmp::Transform* t = topWall.get<cmp::Transform>())
+        t->position.y = sources.top;
+    if (cmp::Transform* t = bottomWall.get<cmp::Transform>())
+        t->position.y = sources.bottom;
+    if (cmp::Transform* t = leftWall.get<cmp::Transform>())
+        t->position.x = sources.left;
+    if (cmp::Transform* t = rightWall.get<cmp::Transform>())
+        t->position.x = sources.right;
+    updateWalls();
 
-        // Apply velocity to boid
-        t->position += atta::vec3(boidInfo->velocity * dt, 0.0f);
-        if (boidInfo->velocity.length() > 0)
-            t->orientation.rotationFromVectors(atta::normalize(atta::vec3(boidInfo->velocity, 0.0f)), atta::vec3(0, -1, 0));
+    // Obstacles (same order as updateObstacles)
+    size_t k = 0, b = 0;
+    for (cmp::Entity obstacle : obstacles.get<cmp::Relationship>()->getChildren()) {
+        cmp::Mesh* obsM = obstacle.get<cmp::Mesh>();
+        cmp::Transform* obsT = obstacle.get<cmp::Transform>();
+        switch (obsM->sid.getId()) {
+        case "meshes/disk.obj"_sid:
+        case "meshes/sphere.obj"_sid:
+            if (k < sources.obstacles.size()) {
+                obsT->position.x = sources.obstacles[k].x;
+                obsT->position.y = sources.obstacles[k].y;
+                obsT->scale.x = sources.obstacles[k].radius;
+            }
+            k++;
+            break;
+        case "meshes/plane.obj"_sid:
+        case "meshes/box.obj"_sid:
+            if (b < sources.boxes.size()) {
+                const BoxObstacle& box = sources.boxes[b];
+                obsT->position.x = box.x;
+                obsT->position.y = box.y;
+                obsT->scale.x = box.width;
+                obsT->scale.y = box.height;
+                // Rotation around z
+                obsT->orientation.r = std::cos(box.angle * 0.5f);
+                obsT->orientation.i = obsT->orientation.j = 0.0f;
+                obsT->orientation.k = std::sin(box.angle * 0.5f);
+            }
+            b++;
+            break;
+        default:
+            break;
+        }
+    }
+    if (k != sources.obstacles.size() || b != sources.boxes.size())
+        LOG_WARN("Project", "Checkpoint has [w]$0[] obstacles, but there are [w]$1[] in the scene",
+                 sources.obstacles.size() + sources.boxes.size(), k + b);
+
+    // Boids
+    _boids = cmp::getFactory(boidPrototype)->getClones();
+    if (_boids.size() != _sim.getState().size()) {
+        LOG_WARN("Project", "Checkpoint has [w]$0[] boids, but there are [w]$1[] clones", _sim.getState().size(), _boids.size());
+        return false;
     }
+    writeBoids();
+    trackBoids();
+    _restored = !_running;
+    return true;
 }
 
 void Project::updateWalls() {
+    PROFILE_SCOPE("updateWalls");
     static cmp::Transform* t = topWall.get<cmp::Transform>();
     static cmp::Transform* b = bottomWall.get<cmp::Transform>();
     static cmp::Transform* l = leftWall.get<cmp::Transform>();
@@ -166,86 +407,90 @@ void Project::updateWalls() {
     }
 }
 
-void getHeatMapColor(float value, float* red, float* green, float* blue) {
-    // Thanks to https://www.andrewnoske.com/wiki/Code_-_heatmaps_and_color_gradients
-    const int NUM_COLORS = 4;
-    static float color[NUM_COLORS][3] = {{0, 0, 1}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}};
-    int idx1;
-    int idx2;
-    float fractBetween = 0;
-    if (value <= 0)
-        idx1 = idx2 = 0;
-    else if (value >= 1)
-        idx1 = idx2 = NUM_COLORS - 1;
-    else {
-        value = value * (NUM_COLORS - 1);
-        idx1 = floor(value);
-        idx2 = idx1 + 1;
-        fractBetween = value - float(idx1);
+void Project::updateObstacles() {
+    PROFILE_SCOPE("updateObstacles");
+    // Walls (the cached force field needs the four walls, it is kept as it is while one of them is missing)
+    cmp::Transform* t = topWall.get<cmp::Transform>();
+    cmp::Transform* b = bottomWall.get<cmp::Transform>();
+    cmp::Transform* l = leftWall.get<cmp::Transform>();
+    cmp::Transform* r = rightWall.get<cmp::Transform>();
+    if (!(t && b && l && r))
+        return;
+    _forceFieldSources.top = t->position.y;
+    _forceFieldSources.bottom = b->position.y;
+    _forceFieldSources.left = l->position.x;
+    _forceFieldSources.right = r->position.x;
+
+    // Dynamic obstacles
+    _forceFieldSources.obstacles.clear();
+    _forceFieldSources.boxes.clear();
+    for (cmp::Entity obstacle : obstacles.get<cmp::Relationship>()->getChildren()) {
+        cmp::Mesh* obsM = obstacle.get<cmp::Mesh>();
+        cmp::Transform* obsT = obstacle.get<cmp::Transform>();
+        switch (obsM->sid.getId()) {
+        case "meshes/disk.obj"_sid:
+        case "meshes/sphere.obj"_sid:
+            _forceFieldSources.obstacles.push_back({obsT->position.x, obsT->position.y, obsT->scale.x});
+            break;
+        case "meshes/plane.obj"_sid:
+        case "meshes/box.obj"_sid: {
+            // Rotation around z
+            const atta::quat& q = obsT->orientation;
+            float angle = std::atan2(2.0f * (q.r * q.k + q.i * q.j), 1.0f - 2.0f * (q.j * q.j + q.k * q.k));
+            _forceFieldSources.boxes.push_back({obsT->position.x, obsT->position.y, obsT->scale.x, obsT->scale.y, angle});
+            break;
+        }
+        default:
+            LOG_WARN("Project", "Trying to avoid unknown obstacle [w]$0[]", obsM->sid.getString());
+        }
     }
-    *red = (color[idx2][0] - color[idx1][0]) * fractBetween + color[idx1][0];
-    *green = (color[idx2][1] - color[idx1][1]) * fractBetween + color[idx1][1];
-    *blue = (color[idx2][2] - color[idx1][2]) * fractBetween + color[idx1][2];
+
+    // Update cached force field
+    auto begin = std::chrono::steady_clock::now();
+    if (_sim.setForceFieldSources(_forceFieldSources))
+        _bgForceFieldTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
 }
 
 void Project::updateBackground() {
+    PROFILE_SCOPE("updateBackground");
     if (!_bgImage)
         return;
 
-    static cmp::Transform* bg = background.get<cmp::Transform>();
-    float relW = 10;
-    float relH = 10;
-    uint32_t width = bg->scale.x * relW;
-    uint32_t height = bg->scale.y * relH;
-    bool shouldUpdate = false;
-
-    // Resize image if necessary
-    if (width != _bgImage->getWidth() || height != _bgImage->getHeight()) {
-        shouldUpdate = true;
+    ForceFieldGrid& forceField = _sim.getForceField();
+    uint32_t width = forceField.getWidth();
+    uint32_t height = forceField.getHeight();
+    if (width == 0 || height == 0)
+        return;
+
+    // Resize image if necessary (the force field was rebuilt, so all tiles are dirty)
+    if (width != _bgImage->getWidth() || height != _bgImage->getHeight())
         _bgImage->resize(width, height);
-    }
+}
 
-    // Check if some obstacle was moved
-    static std::vector<cmp::Transform> lastTransforms;
-    lastTransforms.resize(obstacles.get<cmp::Relationship>()->getChildren().size());
-    unsigned i = 0;
-    for (cmp::Entity obstacle : obstacles.get<cmp::Relationship>()->getChildren()) {
-        cmp::Transform* t = obstacle.get<cmp::Transform>();
-        cmp::Transform& lt = lastTransforms[i];
-        if (lt.position != t->position || lt.scale != t->scale) {
-            shouldUpdate = true;
-            break;
-        }
-        i++;
-    }
-    i = 0;
-    for (cmp::Entity obstacle : obstacles.get<cmp::Relationship>()->getChildren()) {
-        lastTransforms[i] = *(obstacle.get<cmp::Transform>());
-        i++;
+void Project::drawBackground(ThreadPool& pool) {
+    // Update curve level of the tiles that changed (one pixel per force field cell)
+    ForceFieldGrid& forceField = _sim.getForceField();
+    _bgTilesDrawn = 0;
+    if (!_bgImage || forceField.getWidth() != _bgImage->getWidth() || forceField.getHeight() != _bgImage->getHeight())
+        return;
+    uint32_t numDirty = forceField.getNumDirtyTiles();
+    if (numDirty) {
+        auto begin = std::chrono::steady_clock::now();
+        drawForceField(forceField, _bgImage->getData(), pool);
+        forceField.clearDirty();
+        _bgPending = true;
+        _bgTilesUpdated = _bgTilesDrawn = numDirty;
+        _bgImageTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
     }
+}
 
-    // Update curve level for force field if necessary
-    if (shouldUpdate) {
-        uint8_t* data = _bgImage->getData();
-        for (int i = 0; i < width; i++)
-            for (int j = 0; j < height; j++) {
-                atta::vec2 start{bg->scale.x / 2, bg->scale.y / 2};
-                atta::vec2 pos = atta::vec2(bg->position) - start + atta::vec2((i + 0.5f) / relW, (j + 0.5f) / relH);
-                atta::vec2 force = getForceField(pos);
-
-                float value = log(log(atta::length(force) + 1) * 2 + 1);
-                if (value > 1)
-                    value = 1;
-                float r, g, b;
-                getHeatMapColor(value, &r, &g, &b);
-
-                unsigned index = (i + (height - 1 - j) * width) * 4;
-                data[index + 0] = 255 * r;
-                data[index + 1] = 255 * g;
-                data[index + 2] = 255 * b;
-                data[index + 3] = 255;
-            }
+void Project::uploadBackground() {
+    // Upload image. While obstacles/walls are being dragged, upload at most every 100ms
+    auto now = std::chrono::steady_clock::now();
+    if (_bgPending && (_bgTilesDrawn == 0 || now - _bgLastUpload >= std::chrono::milliseconds(100))) {
         _bgImage->update();
+        _bgPending = false;
+        _bgLastUpload = now;
     }
 }
 
@@ -6,11 +6,20 @@
 //--------------------------------------------------
 #ifndef PROJECT_SCRIPT_H
 #define PROJECT_SCRIPT_H
+#include "profiler.h"
+#include "simulation.h"
+#include "stepScheduler.h"
+#include "taskGraph.h"
+#include "trajectory.h"
+#include <atta/component/interface.h>
 #include <atta/resource/resources/image.h>
 #include <atta/script/projectScript.h>
+#include <chrono>
 
+namespace cmp = atta::component;
 namespace scr = atta::script;
 namespace rsc = atta::resource;
+namespace gfx = atta::graphics;
 
 class Project : public scr::ProjectScript {
   public:
@@ -29,15 +38,88 @@ class Project : public scr::ProjectScript {
   private:
     void initBoids();
     void updateWalls();
+    void updateObstacles();
+    /// Resize background image to the force field
     void updateBackground();
+    /// Update curve level of the dirty tiles (task of the frame graph, with the simulation thread pool)
+    void drawBackground(ThreadPool& pool);
+    void uploadBackground();
+    /// Tasks of onUpdateAfter (created once)
+    void createFrameGraph();
+    /// Run steps of this frame (or play the recorded step) and publish the snapshot
+    void runSteps(float dt);
+    /// Move the view radius disks to the published snapshot (once per frame)
+    void updateViewRadius();
+    /// Delete the view radius disks
+    void clearViewRadius();
+    /// Close the trajectory file (warns if a write failed)
+    void stopRecording();
+    /// Copy recorded step to the boid components
+    bool loadReplayStep();
+    /// Load checkpoint and copy it to the components (boids, settings, walls and obstacles)
+    bool restoreCheckpoint();
+    /// Update the simulation from the boid clones, which are tracked by entity
+    /** Clones that were not boids in the last frame start at random positions and despawned boids are removed, also when the number of
+     * clones does not change **/
+    void syncBoids();
+    /// Remember the entity of each boid id (after the state was written to the components)
+    void trackBoids();
+    /// Copy boid components to the simulation state
+    void readBoids();
+    /// Copy simulation state to the boid components (starting from boid first)
+    void writeBoids(uint32_t first = 0);
 
     // UI
     void mainParemeters();
     void boidParemeters();
+    void simulationParemeters();
+    void trajectoryParemeters();
+    void checkpointParemeters();
     void boidInspect();
+    void profilerPanel();
+    void frameGraphPanel();
 
     bool _running;
+    bool _showViewRadius;
     rsc::Image* _bgImage;
+    bool _bgPending; ///< Background changed but was not uploaded yet
+    std::chrono::steady_clock::time_point _bgLastUpload;
+    float _bgForceFieldTime; ///< Last force field update time (ms)
+    float _bgImageTime;      ///< Last background image update time (ms)
+    uint32_t _bgTilesUpdated;
+    uint32_t _bgTilesDrawn; ///< Tiles drawn in this frame
+    unsigned _seed;
+
+    // Boid update
+    Simulation _sim;
+    StepScheduler _scheduler;
+    std::chrono::steady_clock::time_point _lastFrame;
+    std::vector<cmp::Entity> _boids;
+    std::vector<cmp::EntityId> _boidEntities; ///< Entity of each boid id in the last frame
+    std::vector<uint32_t> _spawned;           ///< Ids of the clones that were not boids
+    ForceFieldSources _forceFieldSources;
+    TaskGraph _frameGraph;
+    float _frameDt; ///< Engine dt of this frame (used by the frame graph)
+    std::string _graphPath;
+
+    // Trajectory
+    TrajectoryWriter _recorder;
+    TrajectoryReader _replay;
+    bool _replaying;     ///< Boids follow the recorded trajectory
+    bool _replayPlaying; ///< Advance one recorded step each simulation step
+    uint64_t _replayStep;
+    std::string _trajectoryPath;
+
+    // Checkpoint
+    std::string _checkpointPath;
+    bool _restored; ///< Checkpoint restored while stopped (boids are not initialized on start)
+
+    // Profiler
+    std::string _tracePath;
+    uint64_t _scriptsBegin; ///< End of onUpdateBefore, the boid scripts run until onUpdateAfter
+
+    // View radius
+    std::vector<cmp::Entity> _viewEntities; ///< One disk per boid while the view radius is shown
 };
 
 ATTA_REGISTER_PROJECT_SCRIPT(Project)
@@ -7,6 +7,9 @@
 #include <imgui.h>
 #include <imgui_internal.h> // Disable items
 #include <implot.h>
+#include <cstdio>
+#include <map>
+#include <thread>
 
 void Project::onUIRender() {
     ImGui::Begin("Configure");
@@ -14,12 +17,23 @@ void Project::onUIRender() {
         mainParemeters();
         ImGui::Separator();
         boidParemeters();
+        ImGui::Separator();
+        simulationParemeters();
+        ImGui::Separator();
+        trajectoryParemeters();
+        ImGui::Separator();
+        checkpointParemeters();
     }
     ImGui::End();
 
     ImGui::Begin("Inspect agent");
     boidInspect();
     ImGui::End();
+
+    ImGui::Begin("Profiler");
+    frameGraphPanel();
+    profilerPanel();
+    ImGui::End();
 }
 
 void Project::mainParemeters() {
@@ -75,41 +89,195 @@ void Project::boidParemeters() {
     ImGui::DragFloat("###DragViewRadius", &s->viewRadius, 0.05f, 0.0f, 100.0f, "%.2f", ImGuiSliderFlags_None);
     ImGui::SameLine();
 
-    static bool showViewRadius = false;
-    if(ImGui::Checkbox("Show##showViewRadius", &showViewRadius) && !showViewRadius)
-        gfx::Drawer::clear<gfx::Drawer::Line>("boidView");
-        
-    if (showViewRadius) {
-        if (_running) {
-            // Clear lines
-            gfx::Drawer::clear<gfx::Drawer::Line>("boidView");
-            // Add lines for each circle
-            for (cmp::Entity boid : cmp::getFactory(boidPrototype)->getClones()) {
-                atta::vec3 pos = boid.get<cmp::Transform>()->position;
-                const int numSections = 50;
-                // Add circle of lines
-                for (int i = 0; i < numSections; i++) {
-                    float angle0 = M_PI * 2 * i / float(numSections);
-                    float angle1 = M_PI * 2 * (i + 1) / float(numSections);
-                    float vr = s->viewRadius;
-                    gfx::Drawer::Line line;
-                    line.p0 = pos + atta::vec3(vr * cos(angle0), vr * sin(angle0), 1.0f);
-                    line.p1 = pos + atta::vec3(vr * cos(angle1), vr * sin(angle1), 1.0f);
-                    line.c0 = line.c1 = {1, 0, 0, 1};
-                    // Add line
-                    gfx::Drawer::add(line, "boidView");
-                }
-            }
-        }
+    if (ImGui::Checkbox("Show##showViewRadius", &_showViewRadius)) {
+        if (_showViewRadius && _running)
+            updateViewRadius();
+        else
+            clearViewRadius();
     }
 
     ImGui::Text("Noise");
     ImGui::DragFloat("###DragNoise", &s->noise, 0.01f, 0.0f, 5.0f, "%.2f", ImGuiSliderFlags_None);
 
+    ImGui::Text("Max neighbors (0 for no limit)");
+    uint32_t minNeighbors = 0;
+    uint32_t maxNeighbors = 256;
+    ImGui::DragScalar("###DragMaxNeighbors", ImGuiDataType_U32, &s->maxNeighbors, 0.2f, &minNeighbors, &maxNeighbors, "%u",
+                      ImGuiSliderFlags_None);
+
     ImGui::Text("Tip: You can move the walls");
     ImGui::Text("Tip: You can add more circles");
 }
 
+void Project::simulationParemeters() {
+    SettingsComponent* s = settings.get<SettingsComponent>();
+
+    ImGui::Text("Simulation parameters");
+
+    ImGui::Dummy(ImVec2(0.0f, 10.0f));
+
+    ImGui::Text("Number of threads");
+    uint32_t minThreads = 1;
+    uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    ImGui::SliderScalar("###SliderNumThreads", ImGuiDataType_U32, &s->numThreads, &minThreads, &maxThreads, "%u", ImGuiSliderFlags_None);
+    ImGui::Text("Running with %u thread(s)", _sim.getPool().getNumThreads());
+    ImGui::Text("Boids: %u (max %u)", _sim.getState().size(), getMaxBoids());
+
+    bool pairMode = _sim.getPairMode();
+    if (ImGui::Checkbox("Symmetric pairs", &pairMode))
+        _sim.setPairMode(pairMode);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Visit each pair of neighbors once and add its contribution to both boids");
+    if (pairMode && !_sim.usePairs())
+        ImGui::Text("Not used with noise or max neighbors");
+
+    // Boid order in memory
+    const char* orders[] = {"Creation", "Morton (Z-order)", "Hilbert"};
+    int order = int(_sim.getOrder());
+    uint32_t interval = _sim.getOrderInterval();
+    uint32_t minInterval = 1;
+    uint32_t maxInterval = 1000;
+    ImGui::Text("Boid order");
+    bool changed = ImGui::Combo("###ComboBoidOrder", &order, orders, IM_ARRAYSIZE(orders));
+    if (order != int(BoidOrder::NONE))
+        changed |= ImGui::DragScalar("Interval (steps)###DragOrderInterval", ImGuiDataType_U32, &interval, 0.5f, &minInterval, &maxInterval,
+                                     "%u", ImGuiSliderFlags_None);
+    if (changed)
+        _sim.setOrder(BoidOrder(order), interval);
+
+    // Level of detail
+    LodSettings lod = _sim.getLod();
+    uint32_t minThreshold = 8;
+    uint32_t maxThreshold = 1024;
+    changed = ImGui::Checkbox("Level of detail", &lod.enabled);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Boids in dense regions use the mean of the cells around them instead of each neighbor");
+    if (lod.enabled) {
+        changed |= ImGui::DragScalar("Threshold###DragLodThreshold", ImGuiDataType_U32, &lod.threshold, 1.0f, &minThreshold, &maxThreshold, "%u",
+                                     ImGuiSliderFlags_None);
+        changed |= ImGui::DragFloat("Close radius###DragLodRadius", &lod.nearRadius, 0.01f, 0.05f, 1.0f, "%.2f", ImGuiSliderFlags_None);
+        ImGui::Text("Boids with level of detail: %u", _sim.getNeighbors().getNumLod());
+    }
+    if (changed)
+        _sim.setLod(lod);
+
+    // Scheduler
+    StepScheduler::Config& config = _scheduler.getConfig();
+    const char* modes[] = {"Real time", "Sub-steps", "As fast as possible"};
+    int mode = int(config.mode);
+    ImGui::Text("Time step");
+    if (ImGui::Combo("###ComboSchedulerMode", &mode, modes, IM_ARRAYSIZE(modes)))
+        config.mode = StepScheduler::Mode(mode);
+    ImGui::DragFloat("dt###DragFixedDt", &config.dt, 0.0001f, 0.0001f, 0.1f, "%.4f", ImGuiSliderFlags_None);
+    uint32_t minSteps = 1;
+    uint32_t maxSteps = 64;
+    switch (config.mode) {
+    case StepScheduler::Mode::REAL_TIME:
+        ImGui::DragFloat("Time scale###DragTimeScale", &config.timeScale, 0.01f, 0.0f, 10.0f, "%.2f", ImGuiSliderFlags_None);
+        ImGui::SliderScalar("Max steps per frame###SliderMaxSteps", ImGuiDataType_U32, &config.maxStepsPerFrame, &minSteps, &maxSteps, "%u",
+                            ImGuiSliderFlags_None);
+        ImGui::ProgressBar(_scheduler.getAlpha(), ImVec2(-1, 0), "Accumulator");
+        ImGui::Text("Accumulator: %.5f s, dropped: %.3f s", _scheduler.getAccumulator(), _scheduler.getDroppedTime());
+        break;
+    case StepScheduler::Mode::SUB_STEPS:
+        ImGui::SliderScalar("Sub-steps###SliderSubSteps", ImGuiDataType_U32, &config.subSteps, &minSteps, &maxSteps, "%u",
+                            ImGuiSliderFlags_None);
+        break;
+    case StepScheduler::Mode::AS_FAST_AS_POSSIBLE: {
+        float budget = config.frameBudget * 1000.0f;
+        if (ImGui::DragFloat("Frame budget (ms)###DragFrameBudget", &budget, 0.5f, 1.0f, 1000.0f, "%.1f", ImGuiSliderFlags_None))
+            config.frameBudget = budget / 1000.0f;
+        break;
+    }
+    }
+    ImGui::Text("Steps last frame: %u (%.2fx real time)", _scheduler.getStepsLastFrame(), _scheduler.getSpeed());
+
+    // Obstacle culling
+    ObstacleCulling culling = _sim.getObstacleCulling();
+    ImGui::Text("Obstacle culling");
+    changed = ImGui::DragFloat("Cutoff###DragObstacleCutoff", &culling.cutoff, 0.05f, 0.0f, 100.0f, "%.2f", ImGuiSliderFlags_None);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Obstacles farther than this are ignored (0 for no cutoff)");
+    changed |= ImGui::DragFloat("Theta###DragObstacleTheta", &culling.theta, 0.01f, 0.0f, 2.0f, "%.2f", ImGuiSliderFlags_None);
+    if (ImGui::IsItemHovered())
+        ImGui::SetTooltip("Groups of obstacles smaller than theta times their distance are replaced by one disk (0 for no grouping)");
+    if (changed)
+        _sim.setObstacleCulling(culling);
+
+    ImGui::Text("Background rebuild");
+    ImGui::Text("Force field: %.2f ms", _bgForceFieldTime);
+    ImGui::Text("Image: %.2f ms (%u tiles)", _bgImageTime, _bgTilesUpdated);
+}
+
+void Project::trajectoryParemeters() {
+    ImGui::Text("Trajectory");
+
+    ImGui::Dummy(ImVec2(0.0f, 10.0f));
+
+    char path[256];
+    std::snprintf(path, sizeof(path), "%s", _trajectoryPath.c_str());
+    if (ImGui::InputText("File###InputTrajectoryFile", path, sizeof(path)))
+        _trajectoryPath = path;
+
+    // Record
+    bool recording = _recorder.isOpen();
+    if (ImGui::Checkbox("Record###CheckboxRecord", &recording)) {
+        if (recording) {
+            _replaying = false;
+            _replay.close();
+            if (!_recorder.open(_trajectoryPath))
+                LOG_WARN("Project", "Could not open [w]$0[] to record", _trajectoryPath);
+        } else
+            stopRecording();
+    }
+    if (_recorder.isOpen()) {
+        ImGui::SameLine();
+        ImGui::Text("%llu steps (%llu dropped), %.2f MB", (unsigned long long)_recorder.getNumRecorded(),
+                    (unsigned long long)_recorder.getNumDropped(), _recorder.getBytesWritten() / 1e6);
+    }
+
+    // Replay
+    if (ImGui::Checkbox("Replay###CheckboxReplay", &_replaying)) {
+        if (_replaying) {
+            stopRecording();
+            if (_replay.open(_trajectoryPath) && _replay.getNumChunks()) {
+                _replayStep = _replay.getFirstStep();
+                loadReplayStep();
+            } else {
+                LOG_WARN("Project", "Could not replay [w]$0[]", _trajectoryPath);
+                _replaying = false;
+            }
+        } else
+            _replay.close();
+    }
+    if (_replaying) {
+        ImGui::SameLine();
+        ImGui::Checkbox("Play###CheckboxReplayPlay", &_replayPlaying);
+        uint64_t first = _replay.getFirstStep();
+        uint64_t last = _replay.getLastStep();
+        if (ImGui::SliderScalar("Step###SliderReplayStep", ImGuiDataType_U64, &_replayStep, &first, &last, "%llu", ImGuiSliderFlags_None))
+            loadReplayStep();
+    }
+}
+
+void Project::checkpointParemeters() {
+    ImGui::Text("Checkpoint");
+
+    ImGui::Dummy(ImVec2(0.0f, 10.0f));
+
+    char path[256];
+    std::snprintf(path, sizeof(path), "%s", _checkpointPath.c_str());
+    if (ImGui::InputText("File###InputCheckpointFile", path, sizeof(path)))
+        _checkpointPath = path;
+
+    if (ImGui::Button("Save###ButtonSaveCheckpoint") && !saveCheckpoint(_checkpointPath, _sim))
+        LOG_WARN("Project", "Could not save checkpoint [w]$0[]", _checkpointPath);
+    ImGui::SameLine();
+    if (ImGui::Button("Load###ButtonLoadCheckpoint"))
+        restoreCheckpoint();
+    ImGui::Text("Step %llu", (unsigned long long)_sim.getStep());
+}
+
 void Project::boidInspect() {
     static std::vector<atta::vec2> pos;
     static std::array<atta::vec2, 20> vel; // Circular buffer
@@ -136,13 +304,21 @@ void Project::boidInspect() {
         }
         lastSelected = selected;
 
-        cmp::Transform* t = selected.get<cmp::Transform>();
-        BoidComponent* b = selected.get<BoidComponent>();
+        // Read from the published snapshot (entity i is the boid with id i)
+        const BoidSnapshot& snapshot = _sim.getSnapshots().acquire();
+        const uint32_t id = selected.getId() - factory->getFirstClone().getId();
+        if (id >= snapshot.size()) {
+            ImGui::Text("Waiting for the first step");
+            return;
+        }
+        const atta::vec2 position(snapshot.state.x[id], snapshot.state.y[id]);
+        const atta::vec2 velocity(snapshot.state.vx[id], snapshot.state.vy[id]);
+        const atta::vec2 acceleration(snapshot.state.ax[id], snapshot.state.ay[id]);
 
         // Update selected boid data
-        pos.push_back(t->position);
-        acc.push_back(b->acceleration);
-        vel[velOffset] = b->velocity;
+        pos.push_back(position);
+        acc.push_back(acceleration);
+        vel[velOffset] = velocity;
         velOffset = (velOffset + 1) % vel.size();
 
         // Show boid info
@@ -150,10 +326,11 @@ void Project::boidInspect() {
         ImGui::Separator();
         ImGui::Text("Info");
         ImGui::Text("EntityId: %d", int(selected.getId()));
-        ImGui::Text("Num neighbors: %zu", b->neighbors.size());
-        ImGui::Text("Position: %s", atta::vec2(t->position).toString().c_str());
-        ImGui::Text("Velocity: %s", b->velocity.toString().c_str());
-        ImGui::Text("Acceleration: %s", b->acceleration.toString().c_str());
+        ImGui::Text("Step: %llu", (unsigned long long)snapshot.step);
+        ImGui::Text("Num neighbors: %u", snapshot.numNeighbors[id]);
+        ImGui::Text("Position: %s", position.toString().c_str());
+        ImGui::Text("Velocity: %s", velocity.toString().c_str());
+        ImGui::Text("Acceleration: %s", acceleration.toString().c_str());
 
         // Plot position
         ImGui::Separator();
@@ -191,3 +368,95 @@ void Project::boidInspect() {
         velOffset = 0;
     }
 }
+
+void Project::frameGraphPanel() {
+    // Tasks of the last frame (background runs on the side thread)
+    ImGui::Text("Frame graph (last %.3f ms)", _frameGraph.getRunTime());
+    for (uint32_t t = 0; t < _frameGraph.size(); t++)
+        ImGui::Text("%s: %.3f ms (start %.3f ms)", _frameGraph.getName(t), _frameGraph.getTime(t), _frameGraph.getStart(t));
+    char path[256];
+    std::snprintf(path, sizeof(path), "%s", _graphPath.c_str());
+    if (ImGui::InputText("File###InputGraphFile", path, sizeof(path)))
+        _graphPath = path;
+    if (ImGui::Button("Export graph###ButtonExportGraph") && !_frameGraph.saveDot(_graphPath))
+        LOG_WARN("Project", "Could not export graph [w]$0[]", _graphPath);
+    ImGui::SameLine();
+    ImGui::Text("Open with Graphviz");
+    ImGui::Separator();
+}
+
+void Project::profilerPanel() {
+#ifdef BOIDS_ENABLE_PROFILER
+    const std::deque<Profiler::Frame>& frames = Profiler::get().getFrames();
+    if (frames.empty()) {
+        ImGui::Text("Start the simulation to profile");
+        return;
+    }
+
+    // Time of each scope per frame (only scopes of this thread, the tasks of the workers are in the trace)
+    const uint32_t thread = Profiler::get().getThread();
+    std::map<std::string, std::vector<float>> scopes;
+    std::vector<float> frameTimes(frames.size());
+    for (size_t f = 0; f < frames.size(); f++) {
+        frameTimes[f] = (frames[f].end - frames[f].begin) / 1e6f;
+        for (const Profiler::Event& e : frames[f].events)
+            if (e.thread == thread) {
+                std::vector<float>& times = scopes[e.name];
+                times.resize(frames.size(), 0.0f);
+                times[f] += e.duration / 1e6f;
+            }
+    }
+
+    ImGui::Text("Frame time (last %u frames)", unsigned(frames.size()));
+    if (ImPlot::BeginPlot("##ProfilerScopes", ImVec2(-1, 250))) {
+        ImPlot::SetupAxes("frame", "ms", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotLine("frame", frameTimes.data(), frameTimes.size());
+        for (const auto& [name, times] : scopes)
+            ImPlot::PlotLine(name.c_str(), times.data(), times.size());
+        ImPlot::EndPlot();
+    }
+    for (const auto& [name, times] : scopes) {
+        float sum = 0.0f;
+        for (float t : times)
+            sum += t;
+        ImGui::Text("%s: %.3f ms (last %.3f ms)", name.c_str(), sum / times.size(), times.back());
+    }
+
+    // Counters of the last frame
+    ImGui::Separator();
+    ImGui::Text("Counters");
+    for (const Profiler::Counter& c : frames.back().counters)
+        ImGui::Text("%s: %.6g", c.name, c.value);
+
+    // Neighbor count histogram
+    ImGui::Separator();
+    ImGui::Text("Neighbors per boid");
+    const NeighborList& neighbors = _sim.getNeighbors();
+    static std::vector<float> histogram;
+    histogram.clear();
+    for (uint32_t i = 0; i < neighbors.getNumBoids(); i++) {
+        uint32_t count = _sim.getNumNeighbors(i);
+        if (count >= histogram.size())
+            histogram.resize(count + 1, 0.0f);
+        histogram[count]++;
+    }
+    if (ImPlot::BeginPlot("##NeighborHistogram", ImVec2(-1, 200))) {
+        ImPlot::SetupAxes("neighbors", "boids", ImPlotAxisFlags_AutoFit, ImPlotAxisFlags_AutoFit);
+        ImPlot::PlotBars("##Neighbors", histogram.data(), histogram.size(), 1.0);
+        ImPlot::EndPlot();
+    }
+
+    // Chrome trace
+    ImGui::Separator();
+    char path[256];
+    std::snprintf(path, sizeof(path), "%s", _tracePath.c_str());
+    if (ImGui::InputText("File###InputTraceFile", path, sizeof(path)))
+        _tracePath = path;
+    if (ImGui::Button("Export trace###ButtonExportTrace") && !Profiler::get().exportTrace(_tracePath))
+        LOG_WARN("Project", "Could not export trace [w]$0[]", _tracePath);
+    ImGui::SameLine();
+    ImGui::Text("Open with chrome://tracing");
+#else
+    ImGui::Text("Profiler disabled (build with BOIDS_ENABLE_PROFILER=ON)");
+#endif
+}
@@ -0,0 +1,53 @@
+//--------------------------------------------------
+// Boids Basic
+// random.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef RANDOM_H
+#define RANDOM_H
+#include <cmath>
+#include <cstdint>
+
+/// Counter-based random number generator
+/** The numbers are a hash (splitmix64 finalizer) of the key and a counter, so creating a generator has no cost and there is no hidden
+ * state to share between threads. Using a different stream for each boid and step, the same numbers are generated no matter which
+ * thread updates the boid
+ **/
+class CounterRng {
+  public:
+    CounterRng(uint64_t seed, uint64_t stream) : _key(mix(seed ^ mix(stream))), _counter(0), _hasSpare(false), _spare(0.0f) {}
+
+    /// Next 64 bits
+    uint64_t next() { return mix(_key + ++_counter * 0x9E3779B97F4A7C15ull); }
+
+    /// Uniform in (0, 1]
+    float uniform() { return ((next() >> 40) + 1) * (1.0f / 16777216.0f); }
+
+    /// Normal with mean 0 and standard deviation 1 (Box-Muller)
+    float normal() {
+        if (_hasSpare) {
+            _hasSpare = false;
+            return _spare;
+        }
+        float r = std::sqrt(-2.0f * std::log(uniform()));
+        float theta = 6.2831853f * uniform();
+        _spare = r * std::sin(theta);
+        _hasSpare = true;
+        return r * std::cos(theta);
+    }
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+  private:
+    uint64_t _key;
+    uint64_t _counter;
+    bool _hasSpare;
+    float _spare;
+};
+
+#endif // RANDOM_H
@@ -0,0 +1,198 @@
+//--------------------------------------------------
+// Boids Basic
+// sceneFile.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "sceneFile.h"
+#include "random.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+
+// Same entities as common.h
+static const int32_t boidPrototypeId = 1;
+static const int32_t backgroundId = 4;
+static const int32_t settingsId = 5;
+static const int32_t topWallId = 6;
+static const int32_t bottomWallId = 7;
+static const int32_t rightWallId = 8;
+static const int32_t leftWallId = 9;
+
+/// Serialized transform (position, orientation, scale)
+static const size_t transformSize = 40;
+
+/// Read a settings attribute at its offset in the serialized SettingsComponent (see settingsComponent.cpp), if the data has it
+template <typename T>
+static void readSetting(const std::vector<char>& data, size_t offset, T& value) {
+    if (offset + sizeof(T) <= data.size())
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+}
+
+using Section = std::vector<char>;
+using Sections = std::map<std::string, Section>;
+
+// The file is a tree of named nodes. Each node is a null terminated name followed by the data size; size -1 means that the node is a list
+// of child nodes between braces. The sections are stored by path, without the version node
+static bool parseNodes(const std::vector<char>& file, size_t& pos, const std::string& path, Sections& sections) {
+    while (pos < file.size()) {
+        if (file[pos] == '}') {
+            pos++;
+            return true;
+        }
+
+        // Name and size
+        size_t end = pos;
+        while (end < file.size() && file[end] != '\0')
+            end++;
+        if (end + 5 > file.size())
+            return false;
+        std::string name(file.begin() + pos, file.begin() + end);
+        int32_t size;
+        std::memcpy(&size, &file[end + 1], sizeof(size));
+        pos = end + 5;
+
+        std::string childPath = path.empty() ? name : path + "/" + name;
+        if (size == -1) {
+            if (pos >= file.size() || file[pos] != '{')
+                return false;
+            pos++;
+            if (!parseNodes(file, pos, path.empty() ? std::string("root") : childPath, sections))
+                return false;
+        } else {
+            if (size < 0 || pos + size > file.size())
+                return false;
+            sections[childPath] = Section(file.begin() + pos, file.begin() + pos + size);
+            pos += size;
+        }
+    }
+    return true;
+}
+
+static std::vector<int32_t> getEntityIds(const Sections& sections, const std::string& component) {
+    std::vector<int32_t> ids;
+    auto it = sections.find("root/componentModule/components/" + component + "/entityIds");
+    if (it != sections.end()) {
+        ids.resize(it->second.size() / sizeof(int32_t));
+        std::memcpy(ids.data(), it->second.data(), ids.size() * sizeof(int32_t));
+    }
+    return ids;
+}
+
+static const Section* getData(const Sections& sections, const std::string& component) {
+    auto it = sections.find("root/componentModule/components/" + component + "/data");
+    return it != sections.end() ? &it->second : nullptr;
+}
+
+bool loadScene(const std::string& filename, Scene& scene) {
+    std::ifstream fs(filename, std::ios::binary);
+    if (!fs)
+        return false;
+    std::vector<char> file((std::istreambuf_iterator<char>(fs)), std::istreambuf_iterator<char>());
+
+    size_t pos = 0;
+    Sections sections;
+    if (!parseNodes(file, pos, "", sections))
+        return false;
+
+    // Transforms (position x/y, scale x/y and rotation around z)
+    std::map<int32_t, std::array<float, 5>> transforms;
+    std::vector<int32_t> transformIds = getEntityIds(sections, "Transform");
+    const Section* transformData = getData(sections, "Transform");
+    if (!transformData || transformData->size() != transformIds.size() * transformSize)
+        return false;
+    for (size_t i = 0; i < transformIds.size(); i++) {
+        float t[10];
+        std::memcpy(t, transformData->data() + i * transformSize, transformSize);
+        // Orientation quaternion stored as (r, i, j, k)
+        float angle = std::atan2(2.0f * (t[3] * t[6] + t[4] * t[5]), 1.0f - 2.0f * (t[5] * t[5] + t[6] * t[6]));
+        transforms[transformIds[i]] = {t[0], t[1], t[7], t[8], angle};
+    }
+
+    // Walls
+    for (int32_t id : {topWallId, bottomWallId, rightWallId, leftWallId})
+        if (!transforms.count(id))
+            return false;
+    scene.sources.top = transforms[topWallId][1];
+    scene.sources.bottom = transforms[bottomWallId][1];
+    scene.sources.right = transforms[rightWallId][0];
+    scene.sources.left = transforms[leftWallId][0];
+
+    // Obstacles (the other entities with disk/sphere/box/plane mesh)
+    scene.sources.obstacles.clear();
+    scene.sources.boxes.clear();
+    std::vector<int32_t> meshIds = getEntityIds(sections, "Mesh");
+    const Section* meshData = getData(sections, "Mesh");
+    if (meshData) {
+        size_t offset = 0;
+        for (int32_t id : meshIds) {
+            if (offset >= meshData->size())
+                break;
+            std::string mesh(meshData->data() + offset);
+            offset += mesh.size() + 1;
+
+            if (id == boidPrototypeId || id == backgroundId || (id >= topWallId && id <= leftWallId) || !transforms.count(id))
+                continue;
+            const std::array<float, 5>& t = transforms[id];
+            if (mesh == "meshes/disk.obj" || mesh == "meshes/sphere.obj")
+                scene.sources.obstacles.push_back({t[0], t[1], t[2]});
+            else if (mesh == "meshes/box.obj" || mesh == "meshes/plane.obj")
+                scene.sources.boxes.push_back({t[0], t[1], t[2], t[3], t[4]});
+        }
+    }
+
+    // Settings (fields that are not in the file keep their default values)
+    std::vector<int32_t> settingsIds = getEntityIds(sections, "Settings");
+    const Section* settingsData = getData(sections, "Settings");
+    if (settingsData && settingsIds.size() == 1 && settingsIds[0] == settingsId) {
+        readSetting(*settingsData, 0, scene.settings.viewRadius);
+        readSetting(*settingsData, 4, scene.settings.collisionAvoidanceFactor);
+        readSetting(*settingsData, 8, scene.settings.velocityMatchingFactor);
+        readSetting(*settingsData, 12, scene.settings.flockCenteringFactor);
+        readSetting(*settingsData, 16, scene.settings.noise);
+        readSetting(*settingsData, 20, scene.settings.maxNeighbors);
+        readSetting(*settingsData, 24, scene.settings.numThreads);
+    }
+
+    // Number of boids (maximum number of prototype clones)
+    std::vector<int32_t> prototypeIds = getEntityIds(sections, "Prototype");
+    const Section* prototypeData = getData(sections, "Prototype");
+    for (size_t i = 0; prototypeData && i < prototypeIds.size(); i++)
+        if (prototypeIds[i] == boidPrototypeId && prototypeData->size() >= (i + 1) * sizeof(uint32_t) * 2)
+            std::memcpy(&scene.numBoids, prototypeData->data() + i * sizeof(uint32_t) * 2, sizeof(uint32_t));
+
+    // Time step
+    auto dt = sections.find("root/config/dt");
+    if (dt != sections.end() && dt->second.size() == sizeof(float))
+        std::memcpy(&scene.dt, dt->second.data(), sizeof(float));
+
+    return true;
+}
+
+Scene generateScene(float width, float height, uint32_t numObstacles, uint64_t seed) {
+    Scene scene;
+    scene.sources.top = height / 2.0f;
+    scene.sources.bottom = -height / 2.0f;
+    scene.sources.right = width / 2.0f;
+    scene.sources.left = -width / 2.0f;
+
+    // Same parameters as boids.atta
+    scene.settings.viewRadius = 1.0f;
+    scene.settings.collisionAvoidanceFactor = 2.85f;
+    scene.settings.velocityMatchingFactor = 5.0f;
+    scene.settings.flockCenteringFactor = 5.0f;
+
+    // Random disks
+    CounterRng rng(CounterRng::mix(seed), 0);
+    for (uint32_t i = 0; i < numObstacles; i++) {
+        float radius = 0.3f + rng.uniform() * 1.2f;
+        float x = (rng.uniform() - 0.5f) * width;
+        float y = (rng.uniform() - 0.5f) * height;
+        scene.sources.obstacles.push_back({x, y, radius});
+    }
+    return scene;
+}
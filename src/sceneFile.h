@@ -0,0 +1,29 @@
+//--------------------------------------------------
+// Boids Basic
+// sceneFile.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef SCENE_FILE_H
+#define SCENE_FILE_H
+#include "simulation.h"
+#include <string>
+
+/// Scene used by the headless runner
+struct Scene {
+    ForceFieldSources sources;
+    SimulationSettings settings;
+    uint32_t numBoids = 0;
+    float dt = 0.01f;
+};
+
+/// Load scene from an atta project file (.atta)
+/** Only what the simulation needs is read from the file: wall positions, disk/sphere/box/plane obstacles, settings, maximum number of boid
+ * clones and dt. Returns false if the file could not be read or parsed
+ **/
+bool loadScene(const std::string& filename, Scene& scene);
+
+/// Generate scene with walls of size (width, height) centered at the origin and random disk obstacles
+Scene generateScene(float width, float height, uint32_t numObstacles, uint64_t seed);
+
+#endif // SCENE_FILE_H
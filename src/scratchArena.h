@@ -0,0 +1,62 @@
+//--------------------------------------------------
+// Boids Basic
+// scratchArena.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Bump allocator for temporary data
+/** Each thread has its own arena, which is reset before each use. Memory is only allocated while the arena is warming up, after that
+ * the same block is reused forever
+ **/
+class ScratchArena {
+  public:
+    ScratchArena() : _offset(0), _size(0), _total(0) {}
+
+    /// Allocate n elements (not initialized), valid until the next reset
+    template <typename T>
+    T* alloc(size_t n) {
+        const size_t align = alignof(T) < 32 ? 32 : alignof(T); // Aligned for SIMD loads
+        const size_t bytes = n * sizeof(T);
+        size_t pad = _blocks.empty() ? 0 : padding(_blocks.back().get() + _offset, align);
+        if (_blocks.empty() || _offset + pad + bytes > _size) {
+            // Previous blocks stay alive until reset, so older pointers remain valid
+            _size = std::max(bytes + align, 2 * _size);
+            _blocks.emplace_back(new uint8_t[_size]);
+            _total += _size;
+            _offset = 0;
+            pad = padding(_blocks.back().get(), align);
+        }
+        T* ptr = reinterpret_cast<T*>(_blocks.back().get() + _offset + pad);
+        _offset += pad + bytes;
+        return ptr;
+    }
+
+    /// Free all allocations (merge blocks so no more memory is allocated next time)
+    void reset() {
+        if (_blocks.size() > 1) {
+            _blocks.clear();
+            _size = _total;
+            _blocks.emplace_back(new uint8_t[_size]);
+        }
+        _total = _size;
+        _offset = 0;
+    }
+
+  private:
+    static size_t padding(const uint8_t* ptr, size_t align) { return (align - reinterpret_cast<uintptr_t>(ptr) % align) % align; }
+
+    std::vector<std::unique_ptr<uint8_t[]>> _blocks;
+    size_t _offset;
+    size_t _size;
+    size_t _total;
+};
+
+#endif // SCRATCH_ARENA_H
@@ -16,7 +16,9 @@ cmp::ComponentDescription& cmp::TypedComponentRegistry<SettingsComponent>::getDe
          {AttributeType::FLOAT32, offsetof(SettingsComponent, collisionAvoidanceFactor), "collisionAvoidanceFactor"},
          {AttributeType::FLOAT32, offsetof(SettingsComponent, velocityMatchingFactor), "velocityMatchingFactor"},
          {AttributeType::FLOAT32, offsetof(SettingsComponent, flockCenteringFactor), "flockCenteringFactor"},
-         {AttributeType::FLOAT32, offsetof(SettingsComponent, noise), "noise"}},
+         {AttributeType::FLOAT32, offsetof(SettingsComponent, noise), "noise"},
+         {AttributeType::UINT32, offsetof(SettingsComponent, maxNeighbors), "maxNeighbors"},
+         {AttributeType::UINT32, offsetof(SettingsComponent, numThreads), "numThreads"}},
         // Max instances
         1};
 
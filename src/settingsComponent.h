@@ -26,6 +26,14 @@ struct SettingsComponent final : public cmp::Component {
 
     /// Measurements noise standand deviation
     float noise;
+
+    /// Maximum number of neighbors
+    /** Only the nearest neighbors are considered when a boid has more neighbors than this (0 for no limit) **/
+    uint32_t maxNeighbors;
+
+    /// Number of threads
+    /** Number of threads used to update the boids **/
+    uint32_t numThreads;
 };
 ATTA_REGISTER_COMPONENT(SettingsComponent);
 template <>
@@ -0,0 +1,328 @@
+//--------------------------------------------------
+// Boids Basic
+// simulation.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "simulation.h"
+#include "profiler.h"
+#include "random.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+static float elapsedMs(std::chrono::steady_clock::time_point begin) {
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+// Spread the 16 low bits of v to the even bits
+static uint32_t spreadBits(uint32_t v) {
+    v &= 0xFFFF;
+    v = (v | (v << 8)) & 0x00FF00FF;
+    v = (v | (v << 4)) & 0x0F0F0F0F;
+    v = (v | (v << 2)) & 0x33333333;
+    v = (v | (v << 1)) & 0x55555555;
+    return v;
+}
+
+static uint32_t mortonKey(uint32_t x, uint32_t y) { return spreadBits(x) | (spreadBits(y) << 1); }
+
+// Distance along the Hilbert curve of order 16
+static uint32_t hilbertKey(uint32_t x, uint32_t y) {
+    uint32_t d = 0;
+    for (uint32_t s = 1u << 15; s > 0; s >>= 1) {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        d += s * s * ((3 * rx) ^ ry);
+        // Rotate quadrant
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+Simulation::Simulation() : _seed(42), _step(0), _numInits(0), _pairMode(false), _order(BoidOrder::NONE), _orderInterval(16) {}
+
+void Simulation::setSettings(const SimulationSettings& settings) {
+    _settings = settings;
+    _pool.setNumThreads(settings.numThreads);
+}
+
+void Simulation::setSeed(uint64_t seed) {
+    _seed = seed;
+    _step = 0;
+    _numInits = 0;
+}
+
+void Simulation::setRandomState(const RandomState& state) {
+    _seed = state.seed;
+    _step = state.step;
+    _numInits = state.numInits;
+}
+
+bool Simulation::setForceFieldSources(const ForceFieldSources& sources) { return _forceField.update(sources, _pool); }
+
+void Simulation::initBoids(uint32_t n) {
+    _state.resize(0);
+    _ids.clear();
+    _slots.clear();
+    addBoids(n);
+}
+
+uint32_t Simulation::addBoids(uint32_t n) {
+    // New boids keep their index as id
+    const uint32_t first = _state.size();
+    _state.resize(first + n);
+    if (_ids.size() != first)
+        setIds(nullptr);
+    for (uint32_t i = first; i < first + n; i++) {
+        _ids.push_back(i);
+        _slots.push_back(i);
+    }
+    placeBoids(_ids.data() + first, n);
+    return first;
+}
+
+void Simulation::placeBoids(const uint32_t* ids, uint32_t n) {
+    const ForceFieldSources& walls = _forceField.getSources();
+    float offsetX = (walls.right + walls.left) / 2.0f;
+    float offsetY = (walls.top + walls.bottom) / 2.0f;
+    float sizeX = walls.right - walls.left;
+    float sizeY = walls.top - walls.bottom;
+
+    // Streams not used by the steering noise
+    CounterRng rng(_seed, ~_numInits++);
+    for (uint32_t k = 0; k < n; k++) {
+        const uint32_t i = _slots[ids[k]];
+        _state.x[i] = (rng.uniform() - 0.5f) * sizeX + offsetX;
+        _state.y[i] = (rng.uniform() - 0.5f) * sizeY + offsetY;
+
+        float angle = rng.uniform();
+        _state.vx[i] = std::cos(angle);
+        _state.vy[i] = std::sin(angle);
+        _state.ax[i] = _state.ay[i] = 0.0f;
+    }
+}
+
+void Simulation::reserve(uint32_t n) {
+    _state.reserve(n);
+    _reordered.reserve(n);
+    _ids.reserve(n);
+    _slots.reserve(n);
+    _snapshots.reserve(n);
+}
+
+void Simulation::setOrder(BoidOrder order, uint32_t interval) {
+    _order = order;
+    _orderInterval = std::max(interval, 1u);
+}
+
+void Simulation::setIds(const uint32_t* ids) {
+    const uint32_t n = _state.size();
+    _ids.resize(n);
+    _slots.resize(n);
+    for (uint32_t i = 0; i < n; i++) {
+        _ids[i] = ids ? ids[i] : i;
+        _slots[_ids[i]] = i;
+    }
+}
+
+void Simulation::reorder() {
+    PROFILE_SCOPE("reorder");
+    auto begin = std::chrono::steady_clock::now();
+    const uint32_t n = _state.size();
+    if (_ids.size() != n)
+        setIds(nullptr);
+    if (_order == BoidOrder::NONE || n < 2)
+        return;
+
+    // Curve over the bounding box of the boids (16 bits for each axis)
+    float minX = _state.x[0], maxX = _state.x[0], minY = _state.y[0], maxY = _state.y[0];
+    for (uint32_t i = 1; i < n; i++) {
+        minX = std::min(minX, _state.x[i]);
+        maxX = std::max(maxX, _state.x[i]);
+        minY = std::min(minY, _state.y[i]);
+        maxY = std::max(maxY, _state.y[i]);
+    }
+    const float scale = 65535.0f / std::max(std::max(maxX - minX, maxY - minY), 1e-6f);
+
+    // Sort by key, ties by id so the order only depends on the positions
+    _sortKeys.resize(n);
+    _pool.parallelFor(n, [&](uint32_t begin, uint32_t end, unsigned) {
+        for (uint32_t i = begin; i < end; i++) {
+            uint32_t qx = std::min((_state.x[i] - minX) * scale, 65535.0f);
+            uint32_t qy = std::min((_state.y[i] - minY) * scale, 65535.0f);
+            uint32_t key = _order == BoidOrder::MORTON ? mortonKey(qx, qy) : hilbertKey(qx, qy);
+            _sortKeys[i] = (uint64_t(key) << 32) | _ids[i];
+        }
+    });
+    std::sort(_sortKeys.begin(), _sortKeys.end());
+
+    // Move boids to their new slots
+    _reordered.resize(n);
+    _pool.parallelFor(n, [&](uint32_t begin, uint32_t end, unsigned) {
+        for (uint32_t k = begin; k < end; k++) {
+            const uint32_t id = uint32_t(_sortKeys[k]);
+            const uint32_t i = _slots[id];
+            _reordered.x[k] = _state.x[i];
+            _reordered.y[k] = _state.y[i];
+            _reordered.vx[k] = _state.vx[i];
+            _reordered.vy[k] = _state.vy[i];
+            _reordered.ax[k] = _state.ax[i];
+            _reordered.ay[k] = _state.ay[i];
+            _ids[k] = id;
+        }
+    });
+    std::swap(_state, _reordered);
+    for (uint32_t k = 0; k < n; k++)
+        _slots[_ids[k]] = k;
+
+    _timing.reorder = elapsedMs(begin);
+}
+
+void Simulation::step(float dt) {
+    _timing.reorder = 0.0f;
+    if (_order != BoidOrder::NONE && _step % _orderInterval == 0)
+        reorder();
+    updateNeighbors();
+    updateSteering();
+    integrate(dt);
+}
+
+void Simulation::addStepTasks(TaskGraph& graph, float dt) {
+    // Order is checked when the task runs, so the graph can be kept when it changes
+    graph.add("reorder", {"step"}, {"positions", "velocities", "accelerations", "ids"}, [this](ThreadPool&) {
+        _timing.reorder = 0.0f;
+        if (_order != BoidOrder::NONE && _step % _orderInterval == 0)
+            reorder();
+    });
+    // The level of detail also reads the velocities (cell sums)
+    graph.add("neighbors", {"positions", "velocities"}, {"neighbors"}, [this](ThreadPool&) { updateNeighbors(); });
+    graph.add("steering", {"positions", "velocities", "ids", "neighbors", "forceField", "step"}, {"accelerations"},
+              [this](ThreadPool&) { updateSteering(); });
+    graph.add("integration", {}, {"positions", "velocities", "accelerations", "step"}, [this, dt](ThreadPool&) { integrate(dt); });
+}
+
+void Simulation::publishSnapshot() {
+    PROFILE_SCOPE("publishSnapshot");
+    BoidSnapshot& snapshot = _snapshots.getBack();
+    const uint32_t n = _state.size();
+    snapshot.state.resize(n);
+    snapshot.numNeighbors.resize(n);
+    snapshot.step = _step;
+    const bool hasNeighbors = _neighbors.getNumBoids() == n;
+    _pool.parallelFor(n, [&](uint32_t begin, uint32_t end, unsigned) {
+        for (uint32_t id = begin; id < end; id++) {
+            const uint32_t k = _slots[id];
+            snapshot.state.x[id] = _state.x[k];
+            snapshot.state.y[id] = _state.y[k];
+            snapshot.state.vx[id] = _state.vx[k];
+            snapshot.state.vy[id] = _state.vy[k];
+            snapshot.state.ax[id] = _state.ax[k];
+            snapshot.state.ay[id] = _state.ay[k];
+            snapshot.numNeighbors[id] = hasNeighbors ? getNumNeighbors(k) : 0;
+        }
+    });
+    _snapshots.publish();
+}
+
+void Simulation::updateNeighbors() {
+    PROFILE_SCOPE("neighbors");
+    auto begin = std::chrono::steady_clock::now();
+    const uint32_t n = _state.size();
+
+    // Rebuild grid (cell size follows the view radius)
+    _grid.build(_state.x.data(), _state.y.data(), n, _settings.viewRadius);
+
+    // Level of detail, cell statistics for dense boids and a finer grid for their close neighbors
+    NeighborLod lod;
+    if (_lod.enabled) {
+        lod.grid = &_nearGrid;
+        lod.radius = _lod.nearRadius * _settings.viewRadius;
+        lod.threshold = _lod.threshold;
+        _grid.buildStats(_state.x.data(), _state.y.data(), _state.vx.data(), _state.vy.data());
+        _nearGrid.build(_state.x.data(), _state.y.data(), n, lod.radius);
+    }
+    _neighbors.build(_grid, _state.x.data(), _state.y.data(), n, _settings.viewRadius, _settings.maxNeighbors, _pool, usePairs(), lod);
+    PROFILE_COUNTER("lod boids", _neighbors.getNumLod());
+    PROFILE_COUNTER("neighbors per boid", n ? double(_neighbors.getTotal()) * (_neighbors.hasPairs() ? 2 : 1) / n : 0.0);
+
+    _timing.neighbors = elapsedMs(begin);
+}
+
+void Simulation::updateSteering() {
+    PROFILE_SCOPE("steering");
+    auto begin = std::chrono::steady_clock::now();
+    SteeringParams params{_settings.collisionAvoidanceFactor,
+                          _settings.velocityMatchingFactor,
+                          _settings.flockCenteringFactor,
+                          obstacleAvoidanceFactor,
+                          _settings.noise,
+                          _seed,
+                          _step,
+                          _ids.size() == _state.size() ? _ids.data() : nullptr,
+                          _neighbors.getNumLod() ? &_grid : nullptr,
+                          _settings.viewRadius};
+
+    if (_neighbors.hasPairs())
+        computeSteeringPairs(_state, _neighbors, _grid, _forceField, params, _pairSums, _pool);
+    else {
+        // The kernel for the active rules is chosen once for each range of boids
+        _scratch.resize(_pool.getNumThreads());
+        _pool.parallelFor(_state.size(), [&](uint32_t begin, uint32_t end, unsigned worker) {
+            computeSteering(_state, _neighbors, _forceField, begin, end, params, _scratch[worker]);
+        });
+    }
+    PROFILE_COUNTER_ADD("force field samples", _state.size());
+
+    _timing.steering = elapsedMs(begin);
+}
+
+void Simulation::integrate(float dt) {
+    PROFILE_SCOPE("integration");
+    auto begin = std::chrono::steady_clock::now();
+
+    _pool.parallelFor(_state.size(), [&](uint32_t begin, uint32_t end, unsigned) {
+        for (uint32_t i = begin; i < end; i++) {
+            float ax = _state.ax[i], ay = _state.ay[i];
+            float vx = _state.vx[i], vy = _state.vy[i];
+
+            // Limit vectors
+            float acc = std::sqrt(ax * ax + ay * ay);
+            if (acc > maxAcc) {
+                ax = ax / acc * maxAcc;
+                ay = ay / acc * maxAcc;
+            }
+            float vel = std::sqrt(vx * vx + vy * vy);
+            if (vel > maxVel) {
+                vx = vx / vel * maxVel;
+                vy = vy / vel * maxVel;
+            }
+
+            // Update velocity
+            vx += ax * dt;
+            vy += ay * dt;
+            vel = std::sqrt(vx * vx + vy * vy);
+            if (vel > 0.0f) {
+                vx /= vel;
+                vy /= vel;
+            }
+
+            // Apply velocity to boid
+            _state.x[i] += vx * dt;
+            _state.y[i] += vy * dt;
+            _state.vx[i] = vx;
+            _state.vy[i] = vy;
+            _state.ax[i] = ax;
+            _state.ay[i] = ay;
+        }
+    });
+    _step++;
+
+    _timing.integration = elapsedMs(begin);
+}
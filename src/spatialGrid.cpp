@@ -0,0 +1,174 @@
+//--------------------------------------------------
+// Boids Basic
+// spatialGrid.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "spatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid() : _cellSize(0.0f), _minX(0.0f), _minY(0.0f), _cols(0), _rows(0) {}
+
+void SpatialGrid::build(const float* x, const float* y, uint32_t n, float cellSize) {
+    // Bounding box of the boids (boids may leave the walls, so the walls can't be used)
+    float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+    if (n) {
+        minX = maxX = x[0];
+        minY = maxY = y[0];
+    }
+    for (uint32_t i = 1; i < n; i++) {
+        minX = std::min(minX, x[i]);
+        maxX = std::max(maxX, x[i]);
+        minY = std::min(minY, y[i]);
+        maxY = std::max(maxY, y[i]);
+    }
+
+    // Limit number of cells when the view radius is too small compared to the boids spread. Bigger cells are still correct because the
+    // neighbors continue to be inside the 3x3 cells around each boid
+    const float maxCells = std::max(1024.0f, 4.0f * n);
+    cellSize = std::max(cellSize, 1e-6f);
+    float cols = std::floor((maxX - minX) / cellSize) + 1.0f;
+    float rows = std::floor((maxY - minY) / cellSize) + 1.0f;
+    if (cols * rows > maxCells) {
+        cellSize *= std::sqrt(cols * rows / maxCells);
+        cols = std::floor((maxX - minX) / cellSize) + 1.0f;
+        rows = std::floor((maxY - minY) / cellSize) + 1.0f;
+    }
+
+    _cellSize = cellSize;
+    _minX = minX;
+    _minY = minY;
+    _cols = uint32_t(cols);
+    _rows = uint32_t(rows);
+
+    // Counting sort
+    _cellStart.assign(_cols * _rows + 1, 0);
+    _boidCell.resize(n);
+    _cellBoids.resize(n);
+    for (uint32_t i = 0; i < n; i++) {
+        _boidCell[i] = cellOf(x[i], y[i]);
+        _cellStart[_boidCell[i] + 1]++;
+    }
+    for (uint32_t c = 0; c < _cols * _rows; c++)
+        _cellStart[c + 1] += _cellStart[c];
+    std::vector<uint32_t>& fill = _scratch;
+    fill.assign(_cellStart.begin(), _cellStart.end() - 1);
+    for (uint32_t i = 0; i < n; i++)
+        _cellBoids[fill[_boidCell[i]]++] = i;
+}
+
+void SpatialGrid::query(const float* x, const float* y, uint32_t i, float radius, std::vector<GridNeighbor>& out) const {
+    const size_t first = out.size();
+    const float r2 = radius * radius;
+    const int cx = _boidCell[i] % _cols;
+    const int cy = _boidCell[i] / _cols;
+
+    for (int gy = std::max(cy - 1, 0); gy <= std::min(cy + 1, int(_rows) - 1); gy++)
+        for (int gx = std::max(cx - 1, 0); gx <= std::min(cx + 1, int(_cols) - 1); gx++) {
+            const uint32_t c = gy * _cols + gx;
+            for (uint32_t k = _cellStart[c]; k < _cellStart[c + 1]; k++) {
+                const uint32_t j = _cellBoids[k];
+                if (j == i)
+                    continue;
+                const float dx = x[j] - x[i];
+                const float dy = y[j] - y[i];
+                const float d2 = dx * dx + dy * dy;
+                if (d2 <= r2)
+                    out.push_back({j, dx, dy, d2});
+            }
+        }
+
+    // Keep same order as iterating over the boids
+    std::sort(out.begin() + first, out.end(), [](const GridNeighbor& a, const GridNeighbor& b) { return a.index < b.index; });
+}
+
+void SpatialGrid::queryForward(const float* x, const float* y, uint32_t i, float radius, std::vector<GridNeighbor>& out) const {
+    const float r2 = radius * radius;
+    const int cx = _boidCell[i] % _cols;
+    const int cy = _boidCell[i] / _cols;
+
+    // Same cell (boids after i), cell above and cells to the right
+    static const int offsets[5][2] = {{0, 0}, {0, 1}, {1, -1}, {1, 0}, {1, 1}};
+    for (const auto& offset : offsets) {
+        const int gx = cx + offset[0];
+        const int gy = cy + offset[1];
+        if (gx >= int(_cols) || gy < 0 || gy >= int(_rows))
+            continue;
+        const uint32_t c = gy * _cols + gx;
+        for (uint32_t k = _cellStart[c]; k < _cellStart[c + 1]; k++) {
+            const uint32_t j = _cellBoids[k];
+            if (c == _boidCell[i] && j <= i)
+                continue;
+            const float dx = x[j] - x[i];
+            const float dy = y[j] - y[i];
+            const float d2 = dx * dx + dy * dy;
+            if (d2 <= r2)
+                out.push_back({j, dx, dy, d2});
+        }
+    }
+}
+
+void SpatialGrid::buildStats(const float* x, const float* y, const float* vx, const float* vy) {
+    _cellSums.resize(_cols * _rows);
+    for (uint32_t c = 0; c < _cols * _rows; c++) {
+        CellSum sum;
+        for (uint32_t k = _cellStart[c]; k < _cellStart[c + 1]; k++) {
+            const uint32_t j = _cellBoids[k];
+            sum.x += x[j];
+            sum.y += y[j];
+            sum.vx += vx[j];
+            sum.vy += vy[j];
+        }
+        sum.count = _cellStart[c + 1] - _cellStart[c];
+        _cellSums[c] = sum;
+    }
+}
+
+uint32_t SpatialGrid::countAround(uint32_t i) const {
+    const int cx = _boidCell[i] % _cols;
+    const int cy = _boidCell[i] / _cols;
+    const int x0 = std::max(cx - 1, 0), x1 = std::min(cx + 1, int(_cols) - 1);
+    uint32_t count = 0;
+    for (int gy = std::max(cy - 1, 0); gy <= std::min(cy + 1, int(_rows) - 1); gy++)
+        count += _cellStart[gy * _cols + x1 + 1] - _cellStart[gy * _cols + x0];
+    return count;
+}
+
+CellSum SpatialGrid::sumAround(const float* x, const float* y, const float* vx, const float* vy, uint32_t i, float radius) const {
+    CellSum out;
+    const float r2 = radius * radius;
+    const int cx = _boidCell[i] % _cols;
+    const int cy = _boidCell[i] / _cols;
+
+    for (int gy = std::max(cy - 1, 0); gy <= std::min(cy + 1, int(_rows) - 1); gy++)
+        for (int gx = std::max(cx - 1, 0); gx <= std::min(cx + 1, int(_cols) - 1); gx++) {
+            const uint32_t c = gy * _cols + gx;
+            CellSum cell = _cellSums[c];
+            if (c == _boidCell[i]) {
+                cell.x -= x[i];
+                cell.y -= y[i];
+                cell.vx -= vx[i];
+                cell.vy -= vy[i];
+                cell.count--;
+            }
+            if (cell.count == 0)
+                continue;
+            const float dx = cell.x / cell.count - x[i];
+            const float dy = cell.y / cell.count - y[i];
+            if (dx * dx + dy * dy > r2)
+                continue;
+            out.x += cell.x;
+            out.y += cell.y;
+            out.vx += cell.vx;
+            out.vy += cell.vy;
+            out.count += cell.count;
+        }
+    return out;
+}
+
+uint32_t SpatialGrid::cellOf(float x, float y) const {
+    const int cx = std::min(int((x - _minX) / _cellSize), int(_cols) - 1);
+    const int cy = std::min(int((y - _minY) / _cellSize), int(_rows) - 1);
+    return std::max(cy, 0) * _cols + std::max(cx, 0);
+}
@@ -0,0 +1,79 @@
+//--------------------------------------------------
+// Boids Basic
+// spatialGrid.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+#include <cstdint>
+#include <vector>
+
+/// Boid found by a grid query
+struct GridNeighbor {
+    uint32_t index;
+    float dx, dy; ///< Vector from the query boid to this boid
+    float d2;     ///< Squared distance
+};
+
+/// Sum of the positions and velocities of the boids of a cell
+struct CellSum {
+    float x = 0.0f, y = 0.0f;
+    float vx = 0.0f, vy = 0.0f;
+    uint32_t count = 0;
+};
+
+/// Uniform grid used to find boid neighbors
+/** The grid is rebuilt from scratch every step using counting sort, which makes the neighbor search O(n) instead of O(n^2).
+ * The cell size is usually the view radius, so the neighbors of a boid are always inside the 3x3 cells around it
+ **/
+class SpatialGrid {
+  public:
+    SpatialGrid();
+
+    /// Rebuild the grid from the boid positions
+    /** The cells are reallocated when the cell size or the covered area changes **/
+    void build(const float* x, const float* y, uint32_t n, float cellSize);
+
+    /// Append to out all boids within radius from boid i (boid i excluded), sorted by index
+    /** The radius must be smaller or equal to the cell size used to build the grid. The vector and distance computed for the radius test
+     * are returned with each boid, so they don't have to be computed again **/
+    void query(const float* x, const float* y, uint32_t i, float radius, std::vector<GridNeighbor>& out) const;
+
+    /// Append to out the boids within radius from boid i in the forward half of the 3x3 cells (not sorted)
+    /** The forward half is the boids of the same cell with greater index, the cell above and the three cells to the right. Each pair of
+     * boids is found by only one of the two boids, and the other boid is at most one column to the right **/
+    void queryForward(const float* x, const float* y, uint32_t i, float radius, std::vector<GridNeighbor>& out) const;
+
+    /// Sum the positions and velocities of the boids of each cell (used by the level of detail)
+    void buildStats(const float* x, const float* y, const float* vx, const float* vy);
+    /// Number of boids in the 3x3 cells around boid i (boid i included)
+    uint32_t countAround(uint32_t i) const;
+    /// Sum of the cells around boid i whose mean position is within radius from it (boid i excluded)
+    /** Each cell stands for all its boids at their mean position, so the cost does not depend on the number of boids. Requires
+     * buildStats **/
+    CellSum sumAround(const float* x, const float* y, const float* vx, const float* vy, uint32_t i, float radius) const;
+
+    float getCellSize() const { return _cellSize; }
+    uint32_t getNumCells() const { return _cols * _rows; }
+    uint32_t getNumCols() const { return _cols; }
+    uint32_t getNumRows() const { return _rows; }
+    /// Boids of cell c (cell index is row * numCols + col), sorted by index
+    const uint32_t* getCellBoids(uint32_t c) const { return _cellBoids.data() + _cellStart[c]; }
+    uint32_t getNumCellBoids(uint32_t c) const { return _cellStart[c + 1] - _cellStart[c]; }
+
+  private:
+    uint32_t cellOf(float x, float y) const;
+
+    float _cellSize;
+    float _minX, _minY;
+    uint32_t _cols, _rows;
+
+    std::vector<uint32_t> _cellStart; ///< Index of the first boid of each cell in _cellBoids (size numCells+1)
+    std::vector<uint32_t> _cellBoids; ///< Boid indices sorted by cell
+    std::vector<uint32_t> _boidCell;  ///< Cell of each boid
+    std::vector<uint32_t> _scratch;   ///< Counting sort insert positions
+    std::vector<CellSum> _cellSums;   ///< Statistics of each cell (see buildStats)
+};
+
+#endif // SPATIAL_GRID_H
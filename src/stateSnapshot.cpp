@@ -0,0 +1,30 @@
+//--------------------------------------------------
+// Boids Basic
+// stateSnapshot.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "stateSnapshot.h"
+
+void BoidSnapshot::reserve(uint32_t n) {
+    state.reserve(n);
+    numNeighbors.reserve(n);
+}
+
+SnapshotBuffer::SnapshotBuffer() : _back(0), _front(2), _middle(1) {}
+
+void SnapshotBuffer::reserve(uint32_t n) {
+    for (BoidSnapshot& buffer : _buffers)
+        buffer.reserve(n);
+}
+
+void SnapshotBuffer::publish() {
+    // Release the back buffer writes, acquire the buffer the reader may have released
+    _back = _middle.exchange(_back | freshBit, std::memory_order_acq_rel) & ~freshBit;
+}
+
+const BoidSnapshot& SnapshotBuffer::acquire() {
+    if (_middle.load(std::memory_order_relaxed) & freshBit)
+        _front = _middle.exchange(_front, std::memory_order_acq_rel) & ~freshBit;
+    return _buffers[_front];
+}
@@ -0,0 +1,54 @@
+//--------------------------------------------------
+// Boids Basic
+// stateSnapshot.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef STATE_SNAPSHOT_H
+#define STATE_SNAPSHOT_H
+#include "steering.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/// Copy of the boid state published after a step
+struct BoidSnapshot {
+    BoidState state;                    ///< In id order
+    std::vector<uint32_t> numNeighbors; ///< In id order
+    uint64_t step = 0;
+
+    void reserve(uint32_t n);
+    uint32_t size() const { return state.size(); }
+};
+
+/// Triple buffer of snapshots, one writer and one reader without locks
+/** The writer fills the back buffer and publishes it, which swaps it atomically with the middle buffer. The reader acquires the front
+ * buffer, which swaps it with the middle buffer if a newer snapshot was published. Each side only touches its own buffer, so the
+ * simulation can keep stepping while the UI reads a consistent snapshot, and neither waits for the other (snapshots that are not
+ * acquired are overwritten).
+ **/
+class SnapshotBuffer {
+  public:
+    SnapshotBuffer();
+
+    void reserve(uint32_t n);
+
+    /// Buffer filled by the writer before publish
+    BoidSnapshot& getBack() { return _buffers[_back]; }
+    /// Make the back buffer the latest snapshot (writer)
+    void publish();
+
+    /// Latest published snapshot, valid until the next acquire (reader)
+    /** Empty until the first publish **/
+    const BoidSnapshot& acquire();
+
+  private:
+    static constexpr uint32_t freshBit = 4; ///< Middle buffer was published and not acquired yet
+
+    BoidSnapshot _buffers[3];
+    uint32_t _back;                ///< Owned by the writer
+    uint32_t _front;               ///< Owned by the reader
+    std::atomic<uint32_t> _middle; ///< Index and freshBit
+};
+
+#endif // STATE_SNAPSHOT_H
@@ -0,0 +1,456 @@
+//--------------------------------------------------
+// Boids Basic
+// steering.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "steering.h"
+#include "forceFieldGrid.h"
+#include "neighborList.h"
+#include "random.h"
+#include "scratchArena.h"
+#include "spatialGrid.h"
+#include "threadPool.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+void BoidState::resize(uint32_t n) {
+    x.resize(n);
+    y.resize(n);
+    vx.resize(n);
+    vy.resize(n);
+    ax.resize(n);
+    ay.resize(n);
+}
+
+void BoidState::reserve(uint32_t n) {
+    x.reserve(n);
+    y.reserve(n);
+    vx.reserve(n);
+    vy.reserve(n);
+    ax.reserve(n);
+    ay.reserve(n);
+}
+
+void PairSums::reset(uint32_t n) {
+    sepX.assign(n, 0.0f);
+    sepY.assign(n, 0.0f);
+    velX.assign(n, 0.0f);
+    velY.assign(n, 0.0f);
+    vecX.assign(n, 0.0f);
+    vecY.assign(n, 0.0f);
+    count.assign(n, 0);
+}
+
+/// Sums accumulated over the neighbors
+struct NeighborSums {
+    float sepX = 0.0f, sepY = 0.0f; ///< Collision avoidance
+    float velX = 0.0f, velY = 0.0f; ///< Velocity matching
+    float vecX = 0.0f, vecY = 0.0f; ///< Flock centering (sum of vectors to neighbors)
+};
+
+/// Neighbors of one boid (see NeighborList)
+struct NeighborData {
+    const uint32_t* indices;
+    const float* dirX; ///< Unit vector to the neighbor
+    const float* dirY;
+    const float* dist; ///< Distance to the neighbor
+    uint32_t count;
+};
+
+// Rules that need the neighbor loop, and rules that need the distance to the neighbors
+static constexpr uint32_t neighborRules = STEER_SEPARATION | STEER_ALIGNMENT | STEER_COHESION;
+static constexpr uint32_t distanceRules = STEER_SEPARATION | STEER_COHESION;
+
+//---------- Scalar ----------//
+// The neighbor vector is the vector from the boid to its neighbor, with noise r[k] added to the distance. The collision avoidance is the
+// inverse square of this vector, pointing away from the neighbor. Overlapping boids do not contribute to collision avoidance
+template <uint32_t Rules>
+static void accumulateScalar(const BoidState& s, const NeighborData& nb, uint32_t begin, const float* r, NeighborSums& sums) {
+    for (uint32_t k = begin; k < nb.count; k++) {
+        if constexpr (Rules & STEER_ALIGNMENT) {
+            uint32_t j = nb.indices[k];
+            sums.velX += s.vx[j];
+            sums.velY += s.vy[j];
+        }
+
+        if constexpr (Rules & distanceRules) {
+            if (nb.dist[k] == 0.0f)
+                continue;
+            float nx = nb.dirX[k];
+            float ny = nb.dirY[k];
+            float dist = nb.dist[k];
+            if constexpr (Rules & STEER_NOISE)
+                dist += r[k];
+            if constexpr (Rules & STEER_COHESION) {
+                sums.vecX += nx * dist;
+                sums.vecY += ny * dist;
+            }
+            if constexpr (Rules & STEER_SEPARATION) {
+                if (dist != 0.0f) {
+                    float m = std::max(std::abs(dist), 0.00001f);
+                    float w = std::copysign(1.0f, dist) / (m * m);
+                    sums.sepX -= nx * w;
+                    sums.sepY -= ny * w;
+                }
+            }
+        }
+    }
+}
+
+//---------- AVX2 ----------//
+#if defined(__AVX2__)
+static float hsum(__m256 v) {
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_hadd_ps(s, s);
+    s = _mm_hadd_ps(s, s);
+    return _mm_cvtss_f32(s);
+}
+
+template <uint32_t Rules>
+static uint32_t accumulateSimd(const BoidState& s, const NeighborData& nb, const float* r, NeighborSums& sums) {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 eps = _mm256_set1_ps(0.00001f);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    __m256 sepX = zero, sepY = zero, velX = zero, velY = zero, vecX = zero, vecY = zero;
+    uint32_t k = 0;
+    for (; k + 8 <= nb.count; k += 8) {
+        if constexpr (Rules & STEER_ALIGNMENT) {
+            __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(nb.indices + k));
+            velX = _mm256_add_ps(velX, _mm256_i32gather_ps(s.vx.data(), idx, 4));
+            velY = _mm256_add_ps(velY, _mm256_i32gather_ps(s.vy.data(), idx, 4));
+        }
+
+        if constexpr (Rules & distanceRules) {
+            __m256 nx = _mm256_loadu_ps(nb.dirX + k);
+            __m256 ny = _mm256_loadu_ps(nb.dirY + k);
+            __m256 dist = _mm256_loadu_ps(nb.dist + k);
+            if constexpr (Rules & STEER_NOISE)
+                dist = _mm256_add_ps(dist, _mm256_loadu_ps(r + k));
+            if constexpr (Rules & STEER_COHESION) {
+                vecX = _mm256_add_ps(vecX, _mm256_mul_ps(nx, dist));
+                vecY = _mm256_add_ps(vecY, _mm256_mul_ps(ny, dist));
+            }
+            if constexpr (Rules & STEER_SEPARATION) {
+                __m256 m = _mm256_max_ps(_mm256_andnot_ps(signMask, dist), eps);
+                __m256 sign = _mm256_or_ps(_mm256_and_ps(dist, signMask), one);
+                __m256 w = _mm256_div_ps(sign, _mm256_mul_ps(m, m));
+                w = _mm256_and_ps(w, _mm256_cmp_ps(dist, zero, _CMP_NEQ_OQ));
+                sepX = _mm256_sub_ps(sepX, _mm256_mul_ps(nx, w));
+                sepY = _mm256_sub_ps(sepY, _mm256_mul_ps(ny, w));
+            }
+        }
+    }
+
+    sums.sepX += hsum(sepX);
+    sums.sepY += hsum(sepY);
+    sums.velX += hsum(velX);
+    sums.velY += hsum(velY);
+    sums.vecX += hsum(vecX);
+    sums.vecY += hsum(vecY);
+    return k;
+}
+
+//---------- NEON ----------//
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+static float32x4_t gather(const std::vector<float>& v, const uint32_t* idx) {
+    float32x4_t r = vdupq_n_f32(v[idx[0]]);
+    r = vsetq_lane_f32(v[idx[1]], r, 1);
+    r = vsetq_lane_f32(v[idx[2]], r, 2);
+    r = vsetq_lane_f32(v[idx[3]], r, 3);
+    return r;
+}
+
+static float32x4_t maskf(float32x4_t v, uint32x4_t mask) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(v), mask)); }
+
+template <uint32_t Rules>
+static uint32_t accumulateSimd(const BoidState& s, const NeighborData& nb, const float* r, NeighborSums& sums) {
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t eps = vdupq_n_f32(0.00001f);
+
+    float32x4_t sepX = zero, sepY = zero, velX = zero, velY = zero, vecX = zero, vecY = zero;
+    uint32_t k = 0;
+    for (; k + 4 <= nb.count; k += 4) {
+        if constexpr (Rules & STEER_ALIGNMENT) {
+            velX = vaddq_f32(velX, gather(s.vx, nb.indices + k));
+            velY = vaddq_f32(velY, gather(s.vy, nb.indices + k));
+        }
+
+        if constexpr (Rules & distanceRules) {
+            float32x4_t nx = vld1q_f32(nb.dirX + k);
+            float32x4_t ny = vld1q_f32(nb.dirY + k);
+            float32x4_t dist = vld1q_f32(nb.dist + k);
+            if constexpr (Rules & STEER_NOISE)
+                dist = vaddq_f32(dist, vld1q_f32(r + k));
+            if constexpr (Rules & STEER_COHESION) {
+                vecX = vaddq_f32(vecX, vmulq_f32(nx, dist));
+                vecY = vaddq_f32(vecY, vmulq_f32(ny, dist));
+            }
+            if constexpr (Rules & STEER_SEPARATION) {
+                float32x4_t m = vmaxq_f32(vabsq_f32(dist), eps);
+                float32x4_t sign = vbslq_f32(vcltq_f32(dist, zero), vdupq_n_f32(-1.0f), vdupq_n_f32(1.0f));
+                float32x4_t w = maskf(vdivq_f32(sign, vmulq_f32(m, m)), vmvnq_u32(vceqq_f32(dist, zero)));
+                sepX = vsubq_f32(sepX, vmulq_f32(nx, w));
+                sepY = vsubq_f32(sepY, vmulq_f32(ny, w));
+            }
+        }
+    }
+
+    sums.sepX += vaddvq_f32(sepX);
+    sums.sepY += vaddvq_f32(sepY);
+    sums.velX += vaddvq_f32(velX);
+    sums.velY += vaddvq_f32(velY);
+    sums.vecX += vaddvq_f32(vecX);
+    sums.vecY += vaddvq_f32(vecY);
+    return k;
+}
+
+//---------- Fallback ----------//
+#else
+template <uint32_t Rules>
+static uint32_t accumulateSimd(const BoidState&, const NeighborData&, const float*, NeighborSums&) {
+    return 0;
+}
+#endif
+
+//---------- Rule pipeline ----------//
+template <uint32_t Rules, bool Lod = false>
+static void applyRules(BoidState& state, uint32_t i, uint32_t numClose, uint32_t numAggregate, const NeighborSums& sums, float noiseX,
+                       float noiseY, const ForceFieldGrid& forceField, const SteeringParams& params) {
+    // Each sum is divided by the number of boids it has: numClose for collision avoidance and the noise, numAggregate for flock
+    // centering and velocity matching (both are the number of neighbors, except with level of detail)
+    float ax = 0.0f, ay = 0.0f;
+    // Collision avoidance
+    if constexpr (Rules & STEER_SEPARATION) {
+        if (numClose) {
+            ax += sums.sepX / numClose * params.collisionAvoidanceFactor;
+            ay += sums.sepY / numClose * params.collisionAvoidanceFactor;
+        }
+    }
+    // Flock centering (steers towards the origin without neighbors)
+    if constexpr (Rules & STEER_COHESION) {
+        if (numAggregate) {
+            ax += sums.vecX / numAggregate * params.flockCenteringFactor;
+            ay += sums.vecY / numAggregate * params.flockCenteringFactor;
+        } else {
+            ax -= state.x[i] * params.flockCenteringFactor;
+            ay -= state.y[i] * params.flockCenteringFactor;
+        }
+    }
+
+    // Velocity matching
+    if constexpr (Rules & STEER_ALIGNMENT) {
+        float vx = state.vx[i];
+        float vy = state.vy[i];
+        if constexpr (Lod) {
+            // Velocities of the cells around, noise of the close neighbors
+            ax += ((vx + sums.velX) / (numAggregate + 1) + noiseX / (numClose + 1) - vx) * params.velocityMatchingFactor;
+            ay += ((vy + sums.velY) / (numAggregate + 1) + noiseY / (numClose + 1) - vy) * params.velocityMatchingFactor;
+        } else {
+            ax += ((vx + sums.velX + noiseX) / (numAggregate + 1) - vx) * params.velocityMatchingFactor;
+            ay += ((vy + sums.velY + noiseY) / (numAggregate + 1) - vy) * params.velocityMatchingFactor;
+        }
+    }
+
+    // Obstacle avoidance
+    if constexpr (Rules & STEER_OBSTACLES) {
+        float fx, fy;
+        forceField.sample(state.x[i], state.y[i], fx, fy);
+        ax += fx * params.obstacleAvoidanceFactor;
+        ay += fy * params.obstacleAvoidanceFactor;
+    }
+
+    state.ax[i] = ax;
+    state.ay[i] = ay;
+}
+
+template <uint32_t Rules, bool Lod>
+static void steerBoid(BoidState& state, uint32_t i, const NeighborData& nb, const ForceFieldGrid& forceField, const SteeringParams& params,
+                      ScratchArena& scratch) {
+    const uint32_t numNeighbors = nb.count;
+    uint32_t numAggregate = numNeighbors; // Boids in the velocity and position sums
+
+    // Measurement noise (distance and velocity of each neighbor)
+    float* r = nullptr;
+    float noiseX = 0.0f, noiseY = 0.0f;
+    if constexpr (Rules & STEER_NOISE) {
+        CounterRng rng(params.seed, (params.step << 32) | (params.ids ? params.ids[i] : i));
+        r = scratch.alloc<float>(numNeighbors);
+        for (uint32_t k = 0; k < numNeighbors; k++) {
+            r[k] = rng.normal() * params.noise;
+            noiseX += rng.normal() * params.noise;
+            noiseY += rng.normal() * params.noise;
+        }
+    }
+
+    // With level of detail, the neighbor list only has the close neighbors and is used only for collision avoidance
+    constexpr uint32_t ListRules = Lod ? Rules & ~(STEER_ALIGNMENT | STEER_COHESION) : Rules;
+    NeighborSums sums;
+    if constexpr (ListRules & neighborRules) {
+        uint32_t k = accumulateSimd<ListRules>(state, nb, r, sums);
+        accumulateScalar<ListRules>(state, nb, k, r, sums);
+    }
+    if constexpr (Lod && (Rules & (STEER_ALIGNMENT | STEER_COHESION))) {
+        CellSum cells = params.lodGrid->sumAround(state.x.data(), state.y.data(), state.vx.data(), state.vy.data(), i, params.lodRadius);
+        sums.velX = cells.vx;
+        sums.velY = cells.vy;
+        sums.vecX = cells.x - cells.count * state.x[i];
+        sums.vecY = cells.y - cells.count * state.y[i];
+        numAggregate = cells.count;
+    }
+    applyRules<Rules, Lod>(state, i, numNeighbors, numAggregate, sums, noiseX, noiseY, forceField, params);
+}
+
+template <uint32_t Rules>
+static void steerRange(BoidState& state, const NeighborList& neighbors, const ForceFieldGrid& forceField, uint32_t begin, uint32_t end,
+                       const SteeringParams& params, ScratchArena& scratch) {
+    for (uint32_t i = begin; i < end; i++) {
+        scratch.reset();
+        NeighborData nb{neighbors.getNeighbors(i), neighbors.getDirX(i), neighbors.getDirY(i), neighbors.getDistances(i),
+                        neighbors.getNumNeighbors(i)};
+        if (params.lodGrid && neighbors.isLod(i))
+            steerBoid<Rules, true>(state, i, nb, forceField, params, scratch);
+        else
+            steerBoid<Rules, false>(state, i, nb, forceField, params, scratch);
+    }
+}
+
+// One kernel for each rule set
+using SteeringKernel = void (*)(BoidState&, const NeighborList&, const ForceFieldGrid&, uint32_t, uint32_t, const SteeringParams&,
+                                ScratchArena&);
+
+template <size_t... Rules>
+static constexpr std::array<SteeringKernel, sizeof...(Rules)> makeKernels(std::index_sequence<Rules...>) {
+    return {{&steerRange<uint32_t(Rules)>...}};
+}
+
+static constexpr std::array<SteeringKernel, STEER_ALL + 1> kernels = makeKernels(std::make_index_sequence<STEER_ALL + 1>());
+
+uint32_t getSteeringRules(const SteeringParams& params) {
+    uint32_t rules = 0;
+    if (params.collisionAvoidanceFactor != 0.0f)
+        rules |= STEER_SEPARATION;
+    if (params.velocityMatchingFactor != 0.0f)
+        rules |= STEER_ALIGNMENT;
+    if (params.flockCenteringFactor != 0.0f)
+        rules |= STEER_COHESION;
+    if (params.obstacleAvoidanceFactor != 0.0f)
+        rules |= STEER_OBSTACLES;
+    if (params.noise > 0.0f && (rules & neighborRules))
+        rules |= STEER_NOISE;
+    return rules;
+}
+
+void computeSteering(BoidState& state, const NeighborList& neighbors, const ForceFieldGrid& forceField, uint32_t begin, uint32_t end,
+                     const SteeringParams& params, ScratchArena& scratch) {
+    kernels[getSteeringRules(params)](state, neighbors, forceField, begin, end, params, scratch);
+}
+
+//---------- Pairs ----------//
+// Contributions of the pairs of the boids of one cell. The contribution to the other boid of the pair is the same with the vector to the
+// neighbor reversed
+template <uint32_t Rules>
+static void accumulatePairs(const BoidState& s, const NeighborList& pairs, const uint32_t* boids, uint32_t numBoids, PairSums& sums) {
+    for (uint32_t b = 0; b < numBoids; b++) {
+        const uint32_t i = boids[b];
+        const uint32_t* indices = pairs.getNeighbors(i);
+        const float* dirX = pairs.getDirX(i);
+        const float* dirY = pairs.getDirY(i);
+        const float* dist = pairs.getDistances(i);
+        const uint32_t numPairs = pairs.getNumNeighbors(i);
+
+        NeighborSums own;
+        for (uint32_t k = 0; k < numPairs; k++) {
+            const uint32_t j = indices[k];
+            sums.count[j]++;
+            if constexpr (Rules & STEER_ALIGNMENT) {
+                own.velX += s.vx[j];
+                own.velY += s.vy[j];
+                sums.velX[j] += s.vx[i];
+                sums.velY[j] += s.vy[i];
+            }
+            if constexpr (Rules & distanceRules) {
+                const float d = dist[k];
+                if (d == 0.0f)
+                    continue;
+                if constexpr (Rules & STEER_COHESION) {
+                    own.vecX += dirX[k] * d;
+                    own.vecY += dirY[k] * d;
+                    sums.vecX[j] -= dirX[k] * d;
+                    sums.vecY[j] -= dirY[k] * d;
+                }
+                if constexpr (Rules & STEER_SEPARATION) {
+                    const float m = std::max(d, 0.00001f);
+                    const float w = 1.0f / (m * m);
+                    own.sepX -= dirX[k] * w;
+                    own.sepY -= dirY[k] * w;
+                    sums.sepX[j] += dirX[k] * w;
+                    sums.sepY[j] += dirY[k] * w;
+                }
+            }
+        }
+
+        sums.count[i] += numPairs;
+        sums.sepX[i] += own.sepX;
+        sums.sepY[i] += own.sepY;
+        sums.velX[i] += own.velX;
+        sums.velY[i] += own.velY;
+        sums.vecX[i] += own.vecX;
+        sums.vecY[i] += own.vecY;
+    }
+}
+
+template <uint32_t Rules>
+static void steerPairs(BoidState& state, const NeighborList& pairs, const SpatialGrid& grid, const ForceFieldGrid& forceField,
+                       const SteeringParams& params, PairSums& sums, ThreadPool& pool) {
+    sums.reset(state.size());
+
+    // Pairs of even columns, then pairs of odd columns
+    if constexpr (Rules & neighborRules) {
+        const uint32_t cols = grid.getNumCols();
+        const uint32_t rows = grid.getNumRows();
+        for (uint32_t pass = 0; pass < 2; pass++)
+            pool.parallelFor(
+                (cols + 1 - pass) / 2,
+                [&](uint32_t begin, uint32_t end, unsigned) {
+                    for (uint32_t c = begin; c < end; c++)
+                        for (uint32_t row = 0; row < rows; row++) {
+                            const uint32_t cell = row * cols + c * 2 + pass;
+                            accumulatePairs<Rules>(state, pairs, grid.getCellBoids(cell), grid.getNumCellBoids(cell), sums);
+                        }
+                },
+                1);
+    }
+
+    pool.parallelFor(state.size(), [&](uint32_t begin, uint32_t end, unsigned) {
+        for (uint32_t i = begin; i < end; i++) {
+            NeighborSums s{sums.sepX[i], sums.sepY[i], sums.velX[i], sums.velY[i], sums.vecX[i], sums.vecY[i]};
+            applyRules<Rules>(state, i, sums.count[i], sums.count[i], s, 0.0f, 0.0f, forceField, params);
+        }
+    });
+}
+
+using PairKernel = void (*)(BoidState&, const NeighborList&, const SpatialGrid&, const ForceFieldGrid&, const SteeringParams&, PairSums&,
+                            ThreadPool&);
+
+template <size_t... Rules>
+static constexpr std::array<PairKernel, sizeof...(Rules)> makePairKernels(std::index_sequence<Rules...>) {
+    return {{&steerPairs<uint32_t(Rules)>...}};
+}
+
+static constexpr std::array<PairKernel, STEER_NOISE> pairKernels = makePairKernels(std::make_index_sequence<STEER_NOISE>());
+
+void computeSteeringPairs(BoidState& state, const NeighborList& pairs, const SpatialGrid& grid, const ForceFieldGrid& forceField,
+                          const SteeringParams& params, PairSums& sums, ThreadPool& pool) {
+    pairKernels[getSteeringRules(params) & ~STEER_NOISE](state, pairs, grid, forceField, params, sums, pool);
+}
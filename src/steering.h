@@ -0,0 +1,100 @@
+//--------------------------------------------------
+// Boids Basic
+// steering.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef STEERING_H
+#define STEERING_H
+#include <cstdint>
+#include <vector>
+
+class ForceFieldGrid;
+class NeighborList;
+class ScratchArena;
+class SpatialGrid;
+class ThreadPool;
+
+/// Boid state in structure-of-arrays layout
+/** Snapshot of all boids built once per step. Positions and velocities are only read during the steering computation, and each boid
+ * only writes its own acceleration
+ **/
+struct BoidState {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> ax;
+    std::vector<float> ay;
+
+    void resize(uint32_t n);
+    void reserve(uint32_t n);
+    uint32_t size() const { return x.size(); }
+};
+
+/// Steering rule parameters
+struct SteeringParams {
+    float collisionAvoidanceFactor;
+    float velocityMatchingFactor;
+    float flockCenteringFactor;
+    float obstacleAvoidanceFactor;
+    float noise;
+
+    uint64_t seed;       ///< Simulation seed
+    uint64_t step;       ///< Simulation step, used to generate different noise at each step
+    const uint32_t* ids; ///< Id of each boid, so the noise does not depend on the boid order (index is used if null)
+
+    const SpatialGrid* lodGrid; ///< Grid with cell statistics, used for the boids with level of detail (see NeighborList::isLod)
+    float lodRadius;            ///< Cells with mean position within this radius are neighbors of the boids with level of detail
+};
+
+/// Steering rules (bit mask)
+enum SteeringRule : uint32_t {
+    STEER_SEPARATION = 1 << 0, ///< Collision avoidance
+    STEER_ALIGNMENT = 1 << 1,  ///< Velocity matching
+    STEER_COHESION = 1 << 2,   ///< Flock centering
+    STEER_OBSTACLES = 1 << 3,  ///< Obstacle and wall avoidance
+    STEER_NOISE = 1 << 4,      ///< Measurement noise
+    STEER_ALL = (1 << 5) - 1
+};
+
+/// Rules that change the result (non-zero factors, noise only if a rule uses the measurements)
+uint32_t getSteeringRules(const SteeringParams& params);
+
+/// Compute acceleration of boids begin to end-1
+/** There is one kernel instantiation for each set of rules, and the one matching getSteeringRules(params) is chosen once per call, so
+ * disabled rules are not evaluated in the inner loop and no noise is sampled when noise is zero. Each kernel visits the neighbors once
+ * and accumulates all its rules at the same time, vectorized with AVX2 or NEON when available.
+ *
+ * Boids with level of detail (dense boids, see NeighborLod) only visit their close neighbors, for collision avoidance. Velocity matching
+ * and flock centering use the sums of the cells around them instead (params.lodGrid), divided by the number of boids in these cells.
+ * Collision avoidance and the velocity noise are divided by the number of close neighbors.
+ *
+ * The result is written to state.ax and state.ay. The scratch arena is reset for each boid (used for the noise samples)
+ **/
+void computeSteering(BoidState& state, const NeighborList& neighbors, const ForceFieldGrid& forceField, uint32_t begin, uint32_t end,
+                     const SteeringParams& params, ScratchArena& scratch);
+
+/// Neighbor sums of all boids, accumulated from the pairs
+struct PairSums {
+    std::vector<float> sepX, sepY; ///< Collision avoidance
+    std::vector<float> velX, velY; ///< Velocity matching
+    std::vector<float> vecX, vecY; ///< Flock centering
+    std::vector<uint32_t> count;   ///< Number of neighbors
+
+    /// Resize to n boids and set all sums to zero
+    void reset(uint32_t n);
+};
+
+/// Compute acceleration of all boids visiting each pair of neighbors once
+/** pairs must be built with one entry per pair (NeighborList::build with pairs) from the same grid. Each pair adds its contribution to
+ * both boids. To avoid two threads writing to the same boid, the grid columns are processed in two passes (even and odd columns), since
+ * the pairs found from one column only reach the next one. The order of the additions does not depend on the number of threads.
+ *
+ * Noise is not supported (the measurements of the two boids of a pair are different), the rules are the ones of getSteeringRules(params)
+ * without STEER_NOISE
+ **/
+void computeSteeringPairs(BoidState& state, const NeighborList& pairs, const SpatialGrid& grid, const ForceFieldGrid& forceField,
+                          const SteeringParams& params, PairSums& sums, ThreadPool& pool);
+
+#endif // STEERING_H
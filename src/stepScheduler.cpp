@@ -0,0 +1,67 @@
+//--------------------------------------------------
+// Boids Basic
+// stepScheduler.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "stepScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+StepScheduler::StepScheduler() { reset(); }
+
+void StepScheduler::reset() {
+    _accumulator = 0.0f;
+    _droppedTime = 0.0f;
+    _frameTime = 0.0f;
+    _steps = 0;
+    _stepsLastFrame = 0;
+    _speed = 0.0f;
+}
+
+void StepScheduler::beginFrame(float frameTime) {
+    // Statistics of the last frame
+    _stepsLastFrame = _steps;
+    _speed = _frameTime > 0.0f ? _steps * _config.dt / _frameTime : 0.0f;
+
+    _steps = 0;
+    _frameTime = std::max(frameTime, 0.0f);
+    _frameStart = std::chrono::steady_clock::now();
+    if (_config.mode == Mode::REAL_TIME)
+        _accumulator += std::min(_frameTime, _config.maxFrameTime) * _config.timeScale;
+    else
+        _accumulator = 0.0f;
+}
+
+bool StepScheduler::nextStep() {
+    if (_config.dt <= 0.0f)
+        return false;
+
+    bool step = false;
+    switch (_config.mode) {
+    case Mode::REAL_TIME:
+        if (_accumulator >= _config.dt) {
+            if (_steps < _config.maxStepsPerFrame) {
+                _accumulator -= _config.dt;
+                step = true;
+            } else {
+                // Behind real time, drop what could not be simulated
+                float dropped = _accumulator - std::fmod(_accumulator, _config.dt);
+                _droppedTime += dropped;
+                _accumulator -= dropped;
+            }
+        }
+        break;
+    case Mode::SUB_STEPS:
+        step = _steps < _config.subSteps;
+        break;
+    case Mode::AS_FAST_AS_POSSIBLE:
+        step = _steps == 0 ||
+               std::chrono::duration<float>(std::chrono::steady_clock::now() - _frameStart).count() < _config.frameBudget;
+        break;
+    }
+
+    if (step)
+        _steps++;
+    return step;
+}
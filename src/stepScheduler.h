@@ -0,0 +1,69 @@
+//--------------------------------------------------
+// Boids Basic
+// stepScheduler.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef STEP_SCHEDULER_H
+#define STEP_SCHEDULER_H
+#include <chrono>
+#include <cstdint>
+
+/// Fixed timestep scheduler
+/** Decides how many simulation steps run in each rendered frame. The simulation always advances with the same fixed dt, so the result
+ * does not depend on the frame rate:
+ *  - REAL_TIME: the frame time is accumulated and one step runs for each dt in the accumulator. To avoid the spiral of death (steps
+ *    taking longer than real time, which makes the next frame need even more steps), at most maxStepsPerFrame steps run per frame and
+ *    the rest of the accumulator is dropped
+ *  - SUB_STEPS: exactly subSteps steps per frame
+ *  - AS_FAST_AS_POSSIBLE: steps run until the frame budget is spent
+ *
+ * Usage: call beginFrame once per frame, then step while nextStep returns true
+ **/
+class StepScheduler {
+  public:
+    enum class Mode : int { REAL_TIME = 0, SUB_STEPS, AS_FAST_AS_POSSIBLE };
+
+    struct Config {
+        Mode mode = Mode::SUB_STEPS;
+        float dt = 0.0f;                 ///< Fixed timestep (s)
+        float timeScale = 1.0f;          ///< Simulated time per real time (REAL_TIME)
+        uint32_t maxStepsPerFrame = 8;   ///< Spiral of death guard (REAL_TIME)
+        float maxFrameTime = 0.25f;      ///< Longer frames (e.g. breakpoints, window dragging) are clamped (REAL_TIME)
+        uint32_t subSteps = 1;           ///< Steps per frame (SUB_STEPS)
+        float frameBudget = 0.015f;      ///< Time spent stepping per frame (AS_FAST_AS_POSSIBLE)
+    };
+
+    StepScheduler();
+
+    Config& getConfig() { return _config; }
+    const Config& getConfig() const { return _config; }
+
+    /// Clear accumulator and statistics
+    void reset();
+
+    /// Start frame, frameTime is the real time since the last frame (s)
+    void beginFrame(float frameTime);
+    /// If one more step should run in this frame
+    bool nextStep();
+
+    float getAccumulator() const { return _accumulator; }
+    /// Fraction of a step in the accumulator (can be used to interpolate rendering)
+    float getAlpha() const { return _config.dt > 0.0f ? _accumulator / _config.dt : 0.0f; }
+    uint32_t getStepsLastFrame() const { return _stepsLastFrame; }
+    float getDroppedTime() const { return _droppedTime; }
+    /// Simulated time per real time in the last frame
+    float getSpeed() const { return _speed; }
+
+  private:
+    Config _config;
+    float _accumulator;
+    float _droppedTime; ///< Total time dropped by the spiral of death guard
+    float _frameTime;
+    uint32_t _steps;    ///< Steps in the current frame
+    uint32_t _stepsLastFrame;
+    float _speed;
+    std::chrono::steady_clock::time_point _frameStart;
+};
+
+#endif // STEP_SCHEDULER_H
@@ -0,0 +1,139 @@
+//--------------------------------------------------
+// Boids Basic
+// sweep.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "sweep.h"
+#include "profiler.h"
+#include "random.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+
+bool setSettingsField(SimulationSettings& settings, const std::string& name, float value) {
+    if (name == "viewRadius")
+        settings.viewRadius = value;
+    else if (name == "collisionAvoidanceFactor")
+        settings.collisionAvoidanceFactor = value;
+    else if (name == "velocityMatchingFactor")
+        settings.velocityMatchingFactor = value;
+    else if (name == "flockCenteringFactor")
+        settings.flockCenteringFactor = value;
+    else if (name == "noise")
+        settings.noise = value;
+    else if (name == "maxNeighbors")
+        settings.maxNeighbors = std::max(std::lround(value), 0l);
+    else
+        return false;
+    return true;
+}
+
+std::vector<SimulationSettings> makeSweepDesign(const SimulationSettings& base, const SweepConfig& config) {
+    const std::vector<SweepParameter>& params = config.parameters;
+    std::vector<SimulationSettings> points;
+
+    if (config.design == SweepDesign::GRID) {
+        // The first parameter changes slowest
+        uint32_t numPoints = 1;
+        for (const SweepParameter& p : params)
+            numPoints *= std::max(p.count, 1u);
+        points.resize(numPoints, base);
+        for (uint32_t i = 0; i < numPoints; i++) {
+            uint32_t rest = i;
+            for (int k = int(params.size()) - 1; k >= 0; k--) {
+                const SweepParameter& p = params[k];
+                const uint32_t count = std::max(p.count, 1u);
+                const uint32_t v = rest % count;
+                rest /= count;
+                setSettingsField(points[i], p.name, count > 1 ? p.min + (p.max - p.min) * v / (count - 1) : p.min);
+            }
+        }
+    } else {
+        // Each parameter uses each of its numSamples strata once, in a random order, at a random position inside the stratum
+        const uint32_t numPoints = config.numSamples;
+        points.resize(numPoints, base);
+        std::vector<uint32_t> strata(numPoints);
+        for (uint32_t k = 0; k < params.size(); k++) {
+            CounterRng rng(config.seed, k);
+            for (uint32_t i = 0; i < numPoints; i++)
+                strata[i] = i;
+            for (uint32_t i = numPoints; i > 1; i--)
+                std::swap(strata[i - 1], strata[rng.next() % i]);
+            for (uint32_t i = 0; i < numPoints; i++) {
+                const float u = (strata[i] + 1.0f - rng.uniform()) / numPoints;
+                setSettingsField(points[i], params[k].name, params[k].min + (params[k].max - params[k].min) * u);
+            }
+        }
+    }
+    return points;
+}
+
+static void addMetrics(FlockMetrics& sum, const FlockMetrics& m, float w) {
+    sum.polarization += m.polarization * w;
+    sum.numClusters += m.numClusters * w;
+    sum.largestCluster += m.largestCluster * w;
+    sum.nearestNeighbor += m.nearestNeighbor * w;
+    sum.isolated += m.isolated * w;
+}
+
+std::vector<SweepRun> runSweep(const Scene& scene, const SweepConfig& config, ThreadPool& pool,
+                               const std::function<void(const SweepRun&)>& onRun) {
+    const std::vector<SimulationSettings> points = makeSweepDesign(scene.settings, config);
+    const uint32_t replicates = std::max(config.replicates, 1u);
+    const uint32_t numRuns = points.size() * replicates;
+    const uint32_t numAverage = std::clamp(config.numAverage, 1u, std::max(config.numSteps, 1u));
+    std::vector<SweepRun> runs(numRuns);
+
+    // Obstacle force field, copied to each run instead of being computed again
+    ForceFieldGrid field;
+    field.update(scene.sources, pool);
+
+    // Profiler counters can't be used by several simulations at the same time
+    const bool profilerEnabled = Profiler::get().isEnabled();
+    Profiler::get().setEnabled(false);
+
+    std::mutex mutex;
+    pool.parallelFor(
+        numRuns,
+        [&](uint32_t begin, uint32_t end, unsigned) {
+            for (uint32_t r = begin; r < end; r++) {
+                auto start = std::chrono::steady_clock::now();
+                SweepRun& run = runs[r];
+                run.index = r;
+                run.point = r / replicates;
+                run.replicate = r % replicates;
+                run.seed = config.seed + run.replicate;
+                run.settings = points[run.point];
+                run.settings.numThreads = 1;
+
+                Simulation sim;
+                sim.setSettings(run.settings);
+                sim.setSeed(run.seed);
+                sim.getForceField().restore(scene.sources, field.getForcesX().data(), field.getForcesY().data(), field.getNumIncremental());
+                sim.initBoids(config.numBoids);
+
+                // Metrics averaged over the last steps
+                FlockAnalyzer analyzer;
+                run.metrics = {};
+                if (config.numSteps == 0)
+                    run.metrics = analyzer.analyze(sim.getState(), run.settings.viewRadius);
+                for (uint32_t s = 0; s < config.numSteps; s++) {
+                    sim.step(config.dt);
+                    if (s + numAverage >= config.numSteps)
+                        addMetrics(run.metrics, analyzer.analyze(sim.getState(), run.settings.viewRadius), 1.0f / numAverage);
+                }
+                run.time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                if (onRun) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    onRun(run);
+                }
+            }
+        },
+        1);
+
+    Profiler::get().setEnabled(profilerEnabled);
+    return runs;
+}
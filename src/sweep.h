@@ -0,0 +1,66 @@
+//--------------------------------------------------
+// Boids Basic
+// sweep.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef SWEEP_H
+#define SWEEP_H
+#include "flockMetrics.h"
+#include "sceneFile.h"
+#include <functional>
+#include <string>
+
+/// Setting changed by a sweep
+struct SweepParameter {
+    std::string name; ///< Field of SimulationSettings (see setSettingsField)
+    float min = 0.0f;
+    float max = 1.0f;
+    uint32_t count = 5; ///< Number of values between min and max (grid design only)
+};
+
+/// How the points of the sweep are chosen
+enum class SweepDesign {
+    GRID,            ///< All combinations of the values of each parameter
+    LATIN_HYPERCUBE, ///< numSamples points, each parameter range split in numSamples strata and each stratum used once
+};
+
+struct SweepConfig {
+    SweepDesign design = SweepDesign::GRID;
+    std::vector<SweepParameter> parameters;
+    uint32_t numSamples = 100; ///< Number of points of the Latin hypercube
+    uint32_t replicates = 1;   ///< Runs of each point, with different seeds
+    uint32_t numBoids = 500;
+    uint32_t numSteps = 1000;
+    uint32_t numAverage = 1; ///< Metrics are the average of the last numAverage steps
+    float dt = 0.01f;
+    uint64_t seed = 42; ///< Seed of the design and of the first replicate
+};
+
+/// Result of one run
+struct SweepRun {
+    uint32_t index; ///< point * replicates + replicate
+    uint32_t point;
+    uint32_t replicate;
+    uint64_t seed;
+    SimulationSettings settings;
+    FlockMetrics metrics;
+    float time; ///< Run time (ms)
+};
+
+/// Set settings field by name, returns false if there is no field with this name
+/** The fields are viewRadius, collisionAvoidanceFactor, velocityMatchingFactor, flockCenteringFactor, noise and maxNeighbors (rounded) **/
+bool setSettingsField(SimulationSettings& settings, const std::string& name, float value);
+
+/// Settings of each point of the design (base settings with the parameters changed)
+std::vector<SimulationSettings> makeSweepDesign(const SimulationSettings& base, const SweepConfig& config);
+
+/// Run all points of the design
+/** Each run is an independent single thread simulation of the scene, and the pool runs one simulation per thread. The obstacle force
+ * field is computed once and copied to all runs. onRun is called when each run finishes (one call at a time, in completion order), the
+ * returned runs are sorted by index. The profiler is disabled while the sweep runs
+ **/
+std::vector<SweepRun> runSweep(const Scene& scene, const SweepConfig& config, ThreadPool& pool,
+                               const std::function<void(const SweepRun&)>& onRun = {});
+
+#endif // SWEEP_H
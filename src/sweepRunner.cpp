@@ -0,0 +1,192 @@
+//--------------------------------------------------
+// Boids Basic
+// sweepRunner.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "sweep.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+// Parameter sweep: runs many small simulations in parallel (one per thread) and writes the flock metrics of each run to a CSV file
+static void printUsage(const char* program) {
+    std::printf("Usage: %s [options]\n"
+                "Scene:\n"
+                "  --scene <file.atta>          Load walls, obstacles, settings and dt from an atta project\n"
+                "  --size <width> <height>      Generated scene size (default 20 10)\n"
+                "  --obstacles <k>              Number of random disks in the generated scene (default 3)\n"
+                "Sweep:\n"
+                "  --param <name> <min> <max> <count>\n"
+                "                               Setting to change: viewRadius, collisionAvoidanceFactor, velocityMatchingFactor,\n"
+                "                               flockCenteringFactor, noise or maxNeighbors (count is only used by the grid design)\n"
+                "  --design <grid|lhs>          Grid of all combinations or Latin hypercube (default grid)\n"
+                "  --samples <n>                Number of Latin hypercube points (default 100)\n"
+                "  --replicates <r>             Runs of each point with different seeds (default 1)\n"
+                "Runs:\n"
+                "  --boids <m>                  Number of boids of each run (default 500)\n"
+                "  --steps <n>                  Number of steps of each run (default 1000)\n"
+                "  --average <k>                Average metrics over the last k steps (default 1)\n"
+                "  --dt <dt>                    Time step (default: from scene file, or 0.01)\n"
+                "  --threads <t>                Number of simultaneous runs (default: number of cores)\n"
+                "  --seed <s>                   Random seed (default 42)\n"
+                "Output:\n"
+                "  --out <file.csv>             One row per run with its settings and metrics (default sweep.csv)\n",
+                program);
+}
+
+int main(int argc, char** argv) {
+    std::string scenePath;
+    std::string outPath = "sweep.csv";
+    float width = 20.0f, height = 10.0f, dt = -1.0f;
+    long numObstacles = 3;
+    unsigned numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    SweepConfig config;
+
+    // Parse arguments
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&](int n = 1) {
+            if (i + n >= argc) {
+                std::fprintf(stderr, "Missing value for %s\n", arg.c_str());
+                std::exit(1);
+            }
+            return argv[++i];
+        };
+        // Numbers must use the whole value and be in range, the usage is printed otherwise
+        auto checkNumber = [&](const char* text, const char* end, bool inRange = true) {
+            if (end == text || *end != '\0' || errno == ERANGE || !inRange) {
+                std::fprintf(stderr, "Invalid value %s for %s\n", text, arg.c_str());
+                printUsage(argv[0]);
+                std::exit(1);
+            }
+        };
+        auto floatValue = [&](int n = 1) {
+            const char* text = value(n);
+            char* end;
+            errno = 0;
+            float number = std::strtof(text, &end);
+            checkNumber(text, end);
+            return number;
+        };
+        auto intValue = [&](int n = 1) {
+            const char* text = value(n);
+            char* end;
+            errno = 0;
+            long number = std::strtol(text, &end, 10);
+            checkNumber(text, end);
+            return number;
+        };
+        auto uintValue = [&](unsigned long long max = UINT32_MAX) {
+            const char* text = value();
+            char* end;
+            errno = 0;
+            unsigned long long number = std::strtoull(text, &end, 10);
+            checkNumber(text, std::strchr(text, '-') ? text : end, number <= max); // strtoull also accepts negative numbers
+            return number;
+        };
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--scene")
+            scenePath = value();
+        else if (arg == "--size") {
+            width = floatValue(2);
+            height = floatValue();
+        } else if (arg == "--obstacles")
+            numObstacles = intValue();
+        else if (arg == "--param") {
+            SweepParameter p;
+            p.name = value(4);
+            p.min = floatValue();
+            p.max = floatValue();
+            p.count = uintValue();
+            SimulationSettings test;
+            if (!setSettingsField(test, p.name, 0.0f)) {
+                std::fprintf(stderr, "Unknown setting %s\n", p.name.c_str());
+                return 1;
+            }
+            config.parameters.push_back(p);
+        } else if (arg == "--design") {
+            std::string design = value();
+            if (design == "grid")
+                config.design = SweepDesign::GRID;
+            else if (design == "lhs")
+                config.design = SweepDesign::LATIN_HYPERCUBE;
+            else {
+                std::fprintf(stderr, "Unknown design %s\n", design.c_str());
+                return 1;
+            }
+        } else if (arg == "--samples")
+            config.numSamples = uintValue();
+        else if (arg == "--replicates")
+            config.replicates = uintValue();
+        else if (arg == "--boids")
+            config.numBoids = uintValue();
+        else if (arg == "--steps")
+            config.numSteps = uintValue();
+        else if (arg == "--average")
+            config.numAverage = uintValue();
+        else if (arg == "--dt")
+            dt = floatValue();
+        else if (arg == "--threads")
+            numThreads = uintValue();
+        else if (arg == "--seed")
+            config.seed = uintValue(UINT64_MAX);
+        else if (arg == "--out")
+            outPath = value();
+        else {
+            std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Load or generate scene
+    Scene scene;
+    if (!scenePath.empty()) {
+        if (!loadScene(scenePath, scene)) {
+            std::fprintf(stderr, "Could not load scene from %s\n", scenePath.c_str());
+            return 1;
+        }
+    } else
+        scene = generateScene(width, height, numObstacles, config.seed);
+    config.dt = dt > 0.0f ? dt : scene.dt;
+
+    FILE* out = std::fopen(outPath.c_str(), "w");
+    if (!out) {
+        std::fprintf(stderr, "Could not open %s\n", outPath.c_str());
+        return 1;
+    }
+    std::fprintf(out, "run,point,replicate,seed,view_radius,collision_avoidance,velocity_matching,flock_centering,noise,max_neighbors,"
+                      "polarization,clusters,largest_cluster,nearest_neighbor,isolated,time_ms\n");
+
+    // Rows are written as the runs finish, so a sweep that is stopped keeps its results
+    const uint32_t numRuns = makeSweepDesign(scene.settings, config).size() * std::max(config.replicates, 1u);
+    std::printf("Running %u runs of %u boids and %u steps on %u thread(s)\n", numRuns, config.numBoids, config.numSteps, numThreads);
+    ThreadPool pool;
+    pool.setNumThreads(numThreads);
+    uint32_t numDone = 0;
+    auto begin = std::chrono::steady_clock::now();
+    runSweep(scene, config, pool, [&](const SweepRun& run) {
+        const SimulationSettings& s = run.settings;
+        const FlockMetrics& m = run.metrics;
+        std::fprintf(out, "%u,%u,%u,%llu,%.7g,%.7g,%.7g,%.7g,%.7g,%u,%.7g,%.7g,%.7g,%.7g,%.7g,%.4f\n", run.index, run.point, run.replicate,
+                     (unsigned long long)run.seed, s.viewRadius, s.collisionAvoidanceFactor, s.velocityMatchingFactor, s.flockCenteringFactor,
+                     s.noise, s.maxNeighbors, m.polarization, m.numClusters, m.largestCluster, m.nearestNeighbor, m.isolated, run.time);
+        std::fflush(out);
+        std::printf("[%u/%u] run %u: polarization %.3f, %.1f clusters (%.2f ms)\n", ++numDone, numRuns, run.index, m.polarization,
+                    m.numClusters, run.time);
+    });
+    std::fclose(out);
+
+    float total = std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("Total %.2f s, %.2f runs/s\n", total, total > 0.0f ? numRuns / total : 0.0f);
+    return 0;
+}
@@ -0,0 +1,202 @@
+//--------------------------------------------------
+// Boids Basic
+// taskGraph.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "taskGraph.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <system_error>
+
+TaskGraph::TaskGraph() : _runTime(0.0f), _numDone(0), _stop(false) {}
+
+TaskGraph::~TaskGraph() { stopSide(); }
+
+uint32_t TaskGraph::add(const char* name, Resources reads, Resources writes, Func func, TaskThread thread) {
+    const uint32_t task = _tasks.size();
+    _tasks.push_back({name, std::move(func), thread, {}, 0, 0, 0.0f, 0.0f});
+
+    // Read after write
+    for (const char* resource : reads) {
+        Resource& r = getResource(resource);
+        if (r.writer >= 0)
+            addEdge(r.writer, task, resource);
+    }
+    // Write after read and write after write
+    for (const char* resource : writes) {
+        Resource& r = getResource(resource);
+        if (r.writer >= 0)
+            addEdge(r.writer, task, resource);
+        for (uint32_t reader : r.readers)
+            addEdge(reader, task, resource);
+    }
+
+    // Update last accesses (after the edges, so a task that reads and writes a resource does not depend on itself)
+    for (const char* resource : reads)
+        getResource(resource).readers.push_back(task);
+    for (const char* resource : writes) {
+        Resource& r = getResource(resource);
+        r.writer = task;
+        r.readers.clear();
+    }
+    return task;
+}
+
+void TaskGraph::precede(uint32_t before, uint32_t after) { addEdge(before, after, ""); }
+
+void TaskGraph::addEdge(uint32_t from, uint32_t to, const char* resource) {
+    if (from == to)
+        return;
+    // One edge for each pair of tasks, with all the resources that create it
+    for (Edge& edge : _tasks[from].next)
+        if (edge.to == to) {
+            if (*resource && (", " + edge.label + ", ").find(std::string(", ") + resource + ", ") == std::string::npos)
+                edge.label += edge.label.empty() ? resource : std::string(", ") + resource;
+            return;
+        }
+    _tasks[from].next.push_back({to, resource});
+    _tasks[to].numPrevious++;
+}
+
+TaskGraph::Resource& TaskGraph::getResource(const char* name) {
+    for (Resource& r : _resources)
+        if (r.name == name)
+            return r;
+    _resources.emplace_back();
+    _resources.back().name = name;
+    return _resources.back();
+}
+
+void TaskGraph::clear() {
+    _tasks.clear();
+    _resources.clear();
+}
+
+void TaskGraph::run(ThreadPool& pool) {
+    PROFILE_SCOPE("task graph");
+    _runBegin = std::chrono::steady_clock::now();
+    if (_tasks.empty())
+        return;
+
+    // Side thread is created when the first graph with side tasks runs
+    bool sideTasks = std::any_of(_tasks.begin(), _tasks.end(), [](const Task& t) { return t.thread == TaskThread::SIDE; });
+#if !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+    if (sideTasks && !_side.joinable()) {
+        try {
+            _side = std::thread(&TaskGraph::sideLoop, this);
+        } catch (const std::system_error&) {
+            // Side tasks run on the calling thread
+        }
+    }
+#endif
+    const bool sideInline = !_side.joinable();
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _numDone = 0;
+        _mainReady.clear();
+        _sideReady.clear();
+        for (uint32_t t = 0; t < _tasks.size(); t++) {
+            _tasks[t].remaining = _tasks[t].numPrevious;
+            if (_tasks[t].remaining == 0)
+                (_tasks[t].thread == TaskThread::SIDE ? _sideReady : _mainReady).push_back(t);
+        }
+    }
+    _cv.notify_all();
+
+    // Main tasks (and side tasks without side thread) in the order they were added, as soon as they are ready
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (_numDone < _tasks.size()) {
+        _cv.wait(lock, [&] { return _numDone == _tasks.size() || !_mainReady.empty() || (sideInline && !_sideReady.empty()); });
+        std::vector<uint32_t>& ready = !_mainReady.empty() ? _mainReady : _sideReady;
+        if (_numDone == _tasks.size() || ready.empty())
+            continue;
+        auto first = std::min_element(ready.begin(), ready.end());
+        const uint32_t task = *first;
+        ready.erase(first);
+        lock.unlock();
+        execute(task, pool);
+        lock.lock();
+        finish(task);
+    }
+    _runTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - _runBegin).count();
+}
+
+void TaskGraph::execute(uint32_t task, ThreadPool& pool) {
+    Task& t = _tasks[task];
+    auto begin = std::chrono::steady_clock::now();
+    {
+        PROFILE_SCOPE(t.name);
+        t.func(pool);
+    }
+    auto end = std::chrono::steady_clock::now();
+    t.start = std::chrono::duration<float, std::milli>(begin - _runBegin).count();
+    t.time = std::chrono::duration<float, std::milli>(end - begin).count();
+}
+
+void TaskGraph::finish(uint32_t task) {
+    _numDone++;
+    for (const Edge& edge : _tasks[task].next) {
+        Task& next = _tasks[edge.to];
+        if (--next.remaining == 0)
+            (next.thread == TaskThread::SIDE ? _sideReady : _mainReady).push_back(edge.to);
+    }
+    _cv.notify_all();
+}
+
+void TaskGraph::sideLoop() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _cv.wait(lock, [&] { return _stop || !_sideReady.empty(); });
+        if (_stop)
+            return;
+        auto first = std::min_element(_sideReady.begin(), _sideReady.end());
+        const uint32_t task = *first;
+        _sideReady.erase(first);
+        lock.unlock();
+        execute(task, _sidePool);
+        lock.lock();
+        finish(task);
+    }
+}
+
+void TaskGraph::stopSide() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    if (_side.joinable())
+        _side.join();
+    _stop = false;
+}
+
+std::string TaskGraph::toDot() const {
+    std::string dot = "digraph TaskGraph {\n"
+                      "    rankdir=LR;\n"
+                      "    node [fontname=\"Helvetica\"];\n"
+                      "    edge [fontname=\"Helvetica\", fontsize=10];\n";
+    char line[256];
+    for (uint32_t t = 0; t < _tasks.size(); t++) {
+        const Task& task = _tasks[t];
+        std::snprintf(line, sizeof(line), "    t%u [label=\"%s\\n%.3f ms\", shape=%s];\n", t, task.name, task.time,
+                      task.thread == TaskThread::SIDE ? "box" : "ellipse");
+        dot += line;
+    }
+    for (uint32_t t = 0; t < _tasks.size(); t++)
+        for (const Edge& edge : _tasks[t].next)
+            dot += "    t" + std::to_string(t) + " -> t" + std::to_string(edge.to) + " [label=\"" + edge.label + "\"];\n";
+    dot += "}\n";
+    return dot;
+}
+
+bool TaskGraph::saveDot(const std::string& filename) const {
+    FILE* file = std::fopen(filename.c_str(), "w");
+    if (!file)
+        return false;
+    std::string dot = toDot();
+    bool ok = std::fwrite(dot.data(), 1, dot.size(), file) == dot.size();
+    return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,115 @@
+//--------------------------------------------------
+// Boids Basic
+// taskGraph.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+#include "threadPool.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Thread that runs a task
+enum class TaskThread {
+    MAIN, ///< Calling thread, with the thread pool (tasks that use parallelFor or engine APIs)
+    SIDE, ///< Side thread, alongside the main tasks (gets a single thread pool)
+};
+
+/// Graph of tasks with declared data dependencies
+/** Each task declares the resources (names of the data it uses) it reads and writes. A task runs after the tasks added before it that
+ * write what it reads, or that read or write what it writes, so the result is the same as running the tasks in the order they were
+ * added. Tasks without dependencies between them run at the same time: main tasks run one at a time on the calling thread (which uses
+ * the thread pool inside them), and side tasks run one at a time on a side thread. Side tasks get a single thread pool (the shared pool
+ * can only be used by one thread at a time) and must not use the profiler counters, which are main thread only.
+ *
+ * The graph is kept after run, so it can be run again (e.g. once per step). Export it with toDot to see the dependencies and the time
+ * of each task in the last run.
+ **/
+class TaskGraph {
+  public:
+    using Func = std::function<void(ThreadPool& pool)>;
+    using Resources = std::initializer_list<const char*>;
+
+    TaskGraph();
+    ~TaskGraph();
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    /// Add task, returns its index
+    /** The name must be a string literal (it is used by the profiler) **/
+    uint32_t add(const char* name, Resources reads, Resources writes, Func func, TaskThread thread = TaskThread::MAIN);
+
+    /// Run task after another task (for dependencies that are not data)
+    void precede(uint32_t before, uint32_t after);
+
+    /// Remove all tasks
+    void clear();
+
+    /// Run all tasks and wait for them
+    void run(ThreadPool& pool);
+
+    uint32_t size() const { return _tasks.size(); }
+    const char* getName(uint32_t task) const { return _tasks[task].name; }
+    /// Start and duration of the task in the last run (ms since the start of the run)
+    float getStart(uint32_t task) const { return _tasks[task].start; }
+    float getTime(uint32_t task) const { return _tasks[task].time; }
+    /// Duration of the last run (ms)
+    float getRunTime() const { return _runTime; }
+
+    /// Graphviz DOT: one node per task with its last time (side tasks are boxes), edges labeled with the resources that create them
+    std::string toDot() const;
+    bool saveDot(const std::string& filename) const;
+
+  private:
+    struct Edge {
+        uint32_t to;
+        std::string label; ///< Resources
+    };
+    struct Task {
+        const char* name;
+        Func func;
+        TaskThread thread;
+        std::vector<Edge> next;
+        uint32_t numPrevious;
+        uint32_t remaining; ///< Previous tasks still running (during run)
+        float start;
+        float time;
+    };
+    struct Resource {
+        std::string name;
+        int32_t writer = -1;           ///< Last task that writes it
+        std::vector<uint32_t> readers; ///< Tasks that read it after the last writer
+    };
+
+    void addEdge(uint32_t from, uint32_t to, const char* resource);
+    Resource& getResource(const char* name);
+    void execute(uint32_t task, ThreadPool& pool);
+    /// Mark task as done and queue the tasks that were waiting for it (with the mutex locked)
+    void finish(uint32_t task);
+    void sideLoop();
+    void stopSide();
+
+    std::vector<Task> _tasks;
+    std::vector<Resource> _resources;
+    float _runTime;
+
+    // Run state
+    std::chrono::steady_clock::time_point _runBegin;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::vector<uint32_t> _mainReady; ///< Ready tasks, sorted so the first added runs first
+    std::vector<uint32_t> _sideReady;
+    uint32_t _numDone;
+    bool _stop;
+    std::thread _side;
+    ThreadPool _sidePool; ///< Single thread
+};
+
+#endif // TASK_GRAPH_H
@@ -0,0 +1,138 @@
+//--------------------------------------------------
+// Boids Basic
+// threadPool.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "threadPool.h"
+#include "profiler.h"
+#include <algorithm>
+#include <system_error>
+
+ThreadPool::ThreadPool() : _generation(0), _stop(false), _remaining(0) { setNumThreads(1); }
+
+ThreadPool::~ThreadPool() { stopWorkers(); }
+
+void ThreadPool::setNumThreads(unsigned numThreads) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    numThreads = 1; // Web build without thread support
+#endif
+    numThreads = std::max(numThreads, 1u);
+    if (numThreads == _queues.size())
+        return;
+
+    stopWorkers();
+    _queues.clear();
+    _queues.push_back(std::make_unique<Queue>());
+    for (unsigned i = 1; i < numThreads; i++) {
+        _queues.push_back(std::make_unique<Queue>());
+        try {
+            _workers.emplace_back(&ThreadPool::workerLoop, this, i);
+        } catch (const std::system_error&) {
+            // Continue with the threads that could be created
+            _queues.pop_back();
+            break;
+        }
+    }
+}
+
+void ThreadPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _wakeCv.notify_all();
+    for (std::thread& worker : _workers)
+        worker.join();
+    _workers.clear();
+    _stop = false;
+}
+
+void ThreadPool::parallelFor(uint32_t n, const Func& func, uint32_t grain) {
+    const unsigned numThreads = _queues.size();
+    if (n == 0)
+        return;
+    if (numThreads == 1) {
+        func(0, n, 0);
+        return;
+    }
+
+    // Split range in chunks, each thread starts with a contiguous block of chunks. The counter is set before the tasks are queued
+    // because workers still looking for tasks of the previous call may run them right away
+    if (grain == 0)
+        grain = std::max(32u, n / (numThreads * 8));
+    const uint32_t numChunks = (n + grain - 1) / grain;
+    _remaining = numChunks;
+    for (unsigned t = 0; t < numThreads; t++) {
+        std::lock_guard<std::mutex> lock(_queues[t]->mutex);
+        for (uint32_t c = uint64_t(numChunks) * t / numThreads; c < uint64_t(numChunks) * (t + 1) / numThreads; c++)
+            _queues[t]->tasks.push_back({c * grain, std::min(n, (c + 1) * grain), &func});
+    }
+
+    // Wake workers
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _generation++;
+    }
+    _wakeCv.notify_all();
+
+    // Calling thread also works
+    runTasks(0);
+
+    // Wait for tasks that were stolen from this thread
+    std::unique_lock<std::mutex> lock(_mutex);
+    _doneCv.wait(lock, [this] { return _remaining == 0; });
+}
+
+void ThreadPool::workerLoop(unsigned worker) {
+    uint64_t generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeCv.wait(lock, [&] { return _stop || _generation != generation; });
+            if (_stop)
+                return;
+            generation = _generation;
+        }
+        runTasks(worker);
+    }
+}
+
+void ThreadPool::runTasks(unsigned worker) {
+    Task task;
+    while (popTask(worker, task)) {
+        {
+            PROFILE_SCOPE("task");
+            (*task.func)(task.begin, task.end, worker);
+        }
+        if (--_remaining == 0) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _doneCv.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::popTask(unsigned worker, Task& task) {
+    // Own queue (front)
+    {
+        Queue& q = *_queues[worker];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            task = q.tasks.front();
+            q.tasks.pop_front();
+            return true;
+        }
+    }
+
+    // Steal from other queues (back)
+    for (unsigned i = 1; i < _queues.size(); i++) {
+        Queue& q = *_queues[(worker + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            task = q.tasks.back();
+            q.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,68 @@
+//--------------------------------------------------
+// Boids Basic
+// threadPool.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Work-stealing thread pool
+/** The range passed to parallelFor is split in chunks, and each thread starts with a contiguous block of chunks. Threads that finish
+ * their block steal chunks from the other threads. The calling thread also works as thread 0.
+ *
+ * The chunks are always the same for the same range and grain, so results are deterministic as long as each index only writes its own
+ * output. The worker index should only be used to select scratch memory.
+ **/
+class ThreadPool {
+  public:
+    using Func = std::function<void(uint32_t begin, uint32_t end, unsigned worker)>;
+
+    ThreadPool();
+    ~ThreadPool();
+
+    /// Set number of threads (including the calling thread)
+    void setNumThreads(unsigned numThreads);
+    unsigned getNumThreads() const { return _queues.size(); }
+
+    /// Execute func over [0, n) split in chunks of size grain (0 to select automatically)
+    void parallelFor(uint32_t n, const Func& func, uint32_t grain = 0);
+
+  private:
+    struct Task {
+        uint32_t begin;
+        uint32_t end;
+        const Func* func;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void stopWorkers();
+    void workerLoop(unsigned worker);
+    /// Execute own tasks first, then steal from other threads. Returns when there are no more tasks
+    void runTasks(unsigned worker);
+    bool popTask(unsigned worker, Task& task);
+
+    std::vector<std::thread> _workers;
+    std::vector<std::unique_ptr<Queue>> _queues; ///< One queue per thread
+
+    std::mutex _mutex;
+    std::condition_variable _wakeCv;
+    std::condition_variable _doneCv;
+    uint64_t _generation;
+    bool _stop;
+    std::atomic<uint32_t> _remaining;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,355 @@
+//--------------------------------------------------
+// Boids Basic
+// trajectory.cpp
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#include "trajectory.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef BOIDS_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+// File layout:
+//  - Header: magic, version, position/velocity/acceleration precision
+//  - Chunks: chunk header followed by payload. The raw payload has, for each step, the deltas of x, y, vx, vy, ax, ay of all boids
+static const char magic[8] = {'B', 'O', 'I', 'D', 'T', 'R', 'A', 'J'};
+static const uint32_t version = 1;
+static const uint32_t numArrays = 6;
+static const uint32_t flagZlib = 1;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    float precision[3];
+};
+static_assert(sizeof(FileHeader) == 24, "Unexpected trajectory header size");
+
+struct ChunkHeader {
+    uint64_t firstStep;
+    uint32_t numSteps;
+    uint32_t numBoids;
+    uint32_t flags;
+    uint32_t rawSize;
+    uint32_t payloadSize;
+    uint32_t reserved;
+};
+static_assert(sizeof(ChunkHeader) == 32, "Unexpected trajectory chunk header size");
+
+static int64_t quantize(float v, float precision) {
+    float q = std::round(v / precision);
+    return std::isfinite(q) ? int64_t(std::clamp(q, -2.0e9f, 2.0e9f)) : 0;
+}
+
+//---------- Writer ----------//
+TrajectoryWriter::TrajectoryWriter()
+    : _file(nullptr), _stop(false), _chunkFirstStep(0), _chunkSteps(0), _chunkBoids(0), _numRecorded(0), _numDropped(0),
+      _bytesWritten(0), _writeFailed(false) {}
+
+TrajectoryWriter::~TrajectoryWriter() { close(); }
+
+bool TrajectoryWriter::open(const std::string& filename, const TrajectoryOptions& options) {
+    close();
+    _file = std::fopen(filename.c_str(), "wb");
+    if (!_file)
+        return false;
+
+    _options = options;
+    _options.chunkSteps = std::max(_options.chunkSteps, 1u);
+#ifndef BOIDS_HAS_ZLIB
+    _options.compress = false;
+#endif
+
+    FileHeader header{};
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.precision[0] = _options.positionPrecision;
+    header.precision[1] = _options.velocityPrecision;
+    header.precision[2] = _options.accelerationPrecision;
+    if (std::fwrite(&header, sizeof(header), 1, _file) != 1) {
+        std::fclose(_file);
+        _file = nullptr;
+        return false;
+    }
+
+    _numRecorded = _numDropped = 0;
+    _bytesWritten = sizeof(header);
+    _chunkSteps = 0;
+    _writeFailed = false;
+    _stop = false;
+    _thread = std::thread(&TrajectoryWriter::writerLoop, this);
+    return true;
+}
+
+bool TrajectoryWriter::close() {
+    if (!_file)
+        return true;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+    bool ok = std::fclose(_file) == 0 && !_writeFailed;
+    _file = nullptr;
+    return ok;
+}
+
+void TrajectoryWriter::record(const BoidState& state, uint64_t step, const uint32_t* slots) {
+    if (!_file)
+        return;
+
+    // Get free frame, the queue holds at most two chunks
+    Frame* frame = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_free.empty()) {
+            frame = _free.back();
+            _free.pop_back();
+        } else if (_frames.size() < _options.chunkSteps * 2) {
+            _frames.push_back(std::make_unique<Frame>());
+            frame = _frames.back().get();
+        }
+    }
+    if (!frame) {
+        _numDropped++;
+        return;
+    }
+
+    // Copy outside the lock (the vectors keep their capacity)
+    frame->step = step;
+    if (slots) {
+        frame->state.resize(state.size());
+        for (uint32_t k = 0; k < state.size(); k++) {
+            const uint32_t i = slots[k];
+            frame->state.x[k] = state.x[i];
+            frame->state.y[k] = state.y[i];
+            frame->state.vx[k] = state.vx[i];
+            frame->state.vy[k] = state.vy[i];
+            frame->state.ax[k] = state.ax[i];
+            frame->state.ay[k] = state.ay[i];
+        }
+    } else {
+        frame->state.x.assign(state.x.begin(), state.x.end());
+        frame->state.y.assign(state.y.begin(), state.y.end());
+        frame->state.vx.assign(state.vx.begin(), state.vx.end());
+        frame->state.vy.assign(state.vy.begin(), state.vy.end());
+        frame->state.ax.assign(state.ax.begin(), state.ax.end());
+        frame->state.ay.assign(state.ay.begin(), state.ay.end());
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _queue.push_back(frame);
+    }
+    _cv.notify_one();
+    _numRecorded++;
+}
+
+void TrajectoryWriter::writerLoop() {
+    while (true) {
+        Frame* frame;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cv.wait(lock, [this] { return _stop || !_queue.empty(); });
+            if (_queue.empty()) {
+                flushChunk();
+                return;
+            }
+            frame = _queue.front();
+            _queue.pop_front();
+        }
+
+        // Start new chunk if the steps are not consecutive or the number of boids changed
+        if (_chunkSteps && (frame->step != _chunkFirstStep + _chunkSteps || frame->state.size() != _chunkBoids))
+            flushChunk();
+        encodeFrame(*frame);
+        if (_chunkSteps == _options.chunkSteps)
+            flushChunk();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        _free.push_back(frame);
+    }
+}
+
+void TrajectoryWriter::encodeFrame(const Frame& frame) {
+    const uint32_t n = frame.state.size();
+    if (_chunkSteps == 0) {
+        _chunkFirstStep = frame.step;
+        _chunkBoids = n;
+        _prev.assign(size_t(n) * numArrays, 0);
+        _raw.clear();
+    }
+
+    const BoidState& s = frame.state;
+    const float* arrays[numArrays] = {s.x.data(), s.y.data(), s.vx.data(), s.vy.data(), s.ax.data(), s.ay.data()};
+    const float precision[numArrays] = {_options.positionPrecision,     _options.positionPrecision,
+                                        _options.velocityPrecision,     _options.velocityPrecision,
+                                        _options.accelerationPrecision, _options.accelerationPrecision};
+    for (uint32_t a = 0; a < numArrays; a++) {
+        const float* values = arrays[a];
+        int64_t* prev = &_prev[size_t(a) * n];
+        for (uint32_t i = 0; i < n; i++) {
+            int64_t q = quantize(values[i], precision[a]);
+            int64_t delta = q - prev[i];
+            prev[i] = q;
+
+            // Zigzag varint
+            uint64_t z = (uint64_t(delta) << 1) ^ uint64_t(delta >> 63);
+            while (z >= 0x80) {
+                _raw.push_back(uint8_t(z) | 0x80);
+                z >>= 7;
+            }
+            _raw.push_back(uint8_t(z));
+        }
+    }
+    _chunkSteps++;
+}
+
+void TrajectoryWriter::flushChunk() {
+    if (_chunkSteps == 0)
+        return;
+
+    ChunkHeader header{};
+    header.firstStep = _chunkFirstStep;
+    header.numSteps = _chunkSteps;
+    header.numBoids = _chunkBoids;
+    header.rawSize = _raw.size();
+
+    const uint8_t* payload = _raw.data();
+    header.payloadSize = _raw.size();
+#ifdef BOIDS_HAS_ZLIB
+    if (_options.compress) {
+        uLongf size = compressBound(_raw.size());
+        _compressed.resize(size);
+        if (compress2(_compressed.data(), &size, _raw.data(), _raw.size(), Z_BEST_SPEED) == Z_OK && size < _raw.size()) {
+            header.flags |= flagZlib;
+            header.payloadSize = size;
+            payload = _compressed.data();
+        }
+    }
+#endif
+
+    if (std::fwrite(&header, sizeof(header), 1, _file) != 1 || std::fwrite(payload, 1, header.payloadSize, _file) != header.payloadSize ||
+        std::fflush(_file) != 0)
+        _writeFailed = true;
+    _bytesWritten += sizeof(header) + header.payloadSize;
+    _chunkSteps = 0;
+}
+
+//---------- Reader ----------//
+TrajectoryReader::TrajectoryReader() : _precision{}, _chunk(-1), _decodedSteps(0), _raw(nullptr), _rawPos(0) {}
+
+bool TrajectoryReader::open(const std::string& filename) {
+    close();
+    if (!_file.open(filename))
+        return false;
+
+    // Header
+    FileHeader header;
+    if (_file.getSize() < sizeof(header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, _file.getData(), sizeof(header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version) {
+        close();
+        return false;
+    }
+    std::memcpy(_precision, header.precision, sizeof(_precision));
+
+    // Chunk index (an incomplete last chunk is ignored)
+    size_t offset = sizeof(header);
+    while (offset + sizeof(ChunkHeader) <= _file.getSize()) {
+        ChunkHeader ch;
+        std::memcpy(&ch, _file.getData() + offset, sizeof(ch));
+        offset += sizeof(ch);
+        if (ch.payloadSize > _file.getSize() - offset)
+            break;
+        // The decoder is bounded by the raw size, which must be the payload for uncompressed chunks
+        if (!(ch.flags & flagZlib) && ch.rawSize != ch.payloadSize) {
+            close();
+            return false;
+        }
+        _chunks.push_back({offset, ch.firstStep, ch.numSteps, ch.numBoids, ch.flags, ch.rawSize, ch.payloadSize});
+        offset += ch.payloadSize;
+    }
+    return true;
+}
+
+void TrajectoryReader::close() {
+    _file.close();
+    _chunks.clear();
+    _chunk = -1;
+    _raw = nullptr;
+}
+
+uint64_t TrajectoryReader::getFirstStep() const { return _chunks.empty() ? 0 : _chunks.front().firstStep; }
+
+uint64_t TrajectoryReader::getLastStep() const { return _chunks.empty() ? 0 : _chunks.back().firstStep + _chunks.back().numSteps - 1; }
+
+bool TrajectoryReader::readStep(uint64_t step, BoidState& state) {
+    // Find chunk
+    auto it = std::upper_bound(_chunks.begin(), _chunks.end(), step, [](uint64_t s, const Chunk& c) { return s < c.firstStep; });
+    if (it == _chunks.begin())
+        return false;
+    const int chunk = int(it - _chunks.begin()) - 1;
+    const Chunk& c = _chunks[chunk];
+    if (step >= c.firstStep + c.numSteps)
+        return false;
+    const uint32_t stepInChunk = step - c.firstStep;
+    const size_t n = c.numBoids;
+
+    // Restart decoding if reading another chunk or going back
+    if (chunk != _chunk || stepInChunk + 1 < _decodedSteps) {
+        _chunk = -1;
+        if (c.flags & flagZlib) {
+#ifdef BOIDS_HAS_ZLIB
+            _decompressed.resize(c.rawSize);
+            uLongf size = c.rawSize;
+            if (uncompress(_decompressed.data(), &size, _file.getData() + c.offset, c.payloadSize) != Z_OK || size != c.rawSize)
+                return false;
+            _raw = _decompressed.data();
+#else
+            return false;
+#endif
+        } else
+            _raw = _file.getData() + c.offset;
+        _rawPos = 0;
+        _decodedSteps = 0;
+        _values.assign(n * numArrays, 0);
+        _chunk = chunk;
+    }
+
+    // Decode steps until the requested one
+    while (_decodedSteps <= stepInChunk) {
+        for (size_t k = 0; k < n * numArrays; k++) {
+            uint64_t z = 0;
+            for (int shift = 0;; shift += 7) {
+                if (_rawPos >= c.rawSize || shift > 63) {
+                    _chunk = -1;
+                    return false;
+                }
+                uint8_t byte = _raw[_rawPos++];
+                z |= uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80))
+                    break;
+            }
+            _values[k] += int64_t(z >> 1) ^ -int64_t(z & 1);
+        }
+        _decodedSteps++;
+    }
+
+    // Dequantize
+    state.resize(n);
+    float* arrays[numArrays] = {state.x.data(), state.y.data(), state.vx.data(), state.vy.data(), state.ax.data(), state.ay.data()};
+    for (uint32_t a = 0; a < numArrays; a++) {
+        float* values = arrays[a];
+        const float precision = _precision[a / 2];
+        for (size_t i = 0; i < n; i++)
+            values[i] = _values[a * n + i] * precision;
+    }
+    return true;
+}
@@ -0,0 +1,131 @@
+//--------------------------------------------------
+// Boids Basic
+// trajectory.h
+// Date: 2026-10-18
+// By Breno Cunha Queiroz
+//--------------------------------------------------
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+#include "mappedFile.h"
+#include "steering.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/// Trajectory file options
+struct TrajectoryOptions {
+    uint32_t chunkSteps = 64;             ///< Maximum number of steps in each chunk
+    float positionPrecision = 1e-4f;      ///< Quantization step of the positions
+    float velocityPrecision = 1e-5f;      ///< Quantization step of the velocities
+    float accelerationPrecision = 1e-4f;  ///< Quantization step of the accelerations
+    bool compress = true;                 ///< Compress chunks with zlib (ignored if zlib is not available)
+};
+
+/// Trajectory recorder
+/** Writes the position, velocity and acceleration of every boid at each step to a binary file. The file is split in chunks of
+ * consecutive steps. Values are quantized, and each step is stored as the difference from the previous step of the chunk (zigzag
+ * varints), so a chunk can be decoded without reading the rest of the file. Chunks are optionally compressed with zlib.
+ *
+ * Encoding and writing run in a background thread. record only copies the state, and drops the step if the writer thread is behind
+ **/
+class TrajectoryWriter {
+  public:
+    TrajectoryWriter();
+    ~TrajectoryWriter();
+
+    bool open(const std::string& filename, const TrajectoryOptions& options = {});
+    /// Write queued steps and close file, returns false if a write failed since open
+    bool close();
+    bool isOpen() const { return _file != nullptr; }
+
+    /// Queue state of a step to be written (does not block)
+    /** If slots is not null, boid k is written from state slot slots[k], so the file is in id order (see Simulation::getSlots) **/
+    void record(const BoidState& state, uint64_t step, const uint32_t* slots = nullptr);
+
+    uint64_t getNumRecorded() const { return _numRecorded; }
+    uint64_t getNumDropped() const { return _numDropped; }
+    uint64_t getBytesWritten() const { return _bytesWritten; }
+
+  private:
+    struct Frame {
+        uint64_t step;
+        BoidState state;
+    };
+
+    void writerLoop();
+    void encodeFrame(const Frame& frame);
+    void flushChunk();
+
+    TrajectoryOptions _options;
+    FILE* _file;
+
+    // Queue (frames are reused)
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<Frame*> _queue;
+    std::vector<Frame*> _free;
+    std::vector<std::unique_ptr<Frame>> _frames;
+    bool _stop;
+    std::thread _thread;
+
+    // Chunk being encoded (writer thread only)
+    uint64_t _chunkFirstStep;
+    uint32_t _chunkSteps;
+    uint32_t _chunkBoids;
+    std::vector<int64_t> _prev; ///< Quantized values of the previous step
+    std::vector<uint8_t> _raw;
+    std::vector<uint8_t> _compressed;
+    bool _writeFailed;
+
+    std::atomic<uint64_t> _numRecorded;
+    std::atomic<uint64_t> _numDropped;
+    std::atomic<uint64_t> _bytesWritten;
+};
+
+/// Trajectory replay
+/** The file is memory mapped and only the chunk of the requested step is decoded. Reading the next step continues from the last decoded
+ * step, so playing or scrubbing forward does not decode the chunk again
+ **/
+class TrajectoryReader {
+  public:
+    TrajectoryReader();
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return _file.isOpen(); }
+
+    uint64_t getFirstStep() const;
+    uint64_t getLastStep() const;
+    uint32_t getNumChunks() const { return _chunks.size(); }
+
+    /// Read state of a step, returns false if the step was not recorded
+    bool readStep(uint64_t step, BoidState& state);
+
+  private:
+    struct Chunk {
+        size_t offset; ///< Payload offset in the file
+        uint64_t firstStep;
+        uint32_t numSteps;
+        uint32_t numBoids;
+        uint32_t flags;
+        uint32_t rawSize;
+        uint32_t payloadSize;
+    };
+
+    MappedFile _file;
+    float _precision[3];
+    std::vector<Chunk> _chunks;
+
+    // Decoding state
+    int _chunk;               ///< Chunk being decoded (-1 if none)
+    uint32_t _decodedSteps;   ///< Number of steps of the chunk that were decoded
+    const uint8_t* _raw;      ///< Chunk data
+    size_t _rawPos;
+    std::vector<uint8_t> _decompressed;
+    std::vector<int64_t> _values; ///< Quantized values of the last decoded step
+};
+
+#endif // TRAJECTORY_H